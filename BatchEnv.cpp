@@ -0,0 +1,889 @@
+#include "BatchEnv.h"
+#include "Pieces.h"
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define BATCH_HAS_X86_KERNELS 1
+#else
+#define BATCH_HAS_X86_KERNELS 0
+#endif
+
+// Bloco do maior kernel (AVX2: 16 linhas de 16 bits por registrador)
+static const int LANE_BLOCK = 16;
+
+// ---------------------------------------------------------------------------
+// Kernels
+//
+// collide: hits[lane] = OU, sobre as linhas y do tabuleiro, de
+//          rows[y][lane] & (linha y - cand_y[lane] da peça já deslocada)
+// drop:    distance[lane] = quantas linhas a peça (já deslocada) cai a partir de
+//          cand_y[lane] até encostar; sem peça (linhas zeradas) fica BOARD_HEIGHT
+// full:    hits[lane] != 0 se alguma linha do tabuleiro está completa
+//
+// Todos olham só a faixa de linhas [block_top, block_bottom] de cada bloco de
+// 16 tabuleiros (as linhas das peças em jogo); blocos sem peça são pulados.
+//
+// As versões SIMD percorrem a faixa para todos os tabuleiros do bloco ao mesmo
+// tempo, escolhendo a linha da peça com comparações (sem desvios).
+// ---------------------------------------------------------------------------
+
+static void collide_scalar(const std::uint16_t* rows, int stride, const std::int16_t* cand_y,
+                           const std::uint16_t* piece_rows, const std::int16_t* block_top,
+                           const std::int16_t* block_bottom, std::uint16_t* hits, int count) {
+    for (int lane = 0; lane < count; ++lane) {
+        if (block_top[lane / LANE_BLOCK] > block_bottom[lane / LANE_BLOCK]) {
+            hits[lane] = 0;
+            continue;
+        }
+        unsigned hit = 0;
+        for (int r = 0; r < 4; ++r) {
+            int y = cand_y[lane] + r;
+            if (y >= 0 && y < BOARD_HEIGHT) hit |= rows[y * stride + lane] & piece_rows[r * stride + lane];
+        }
+        hits[lane] = static_cast<std::uint16_t>(hit);
+    }
+}
+
+static void drop_scalar(const std::uint16_t* rows, int stride, const std::int16_t* cand_y,
+                        const std::uint16_t* piece_rows, const std::int16_t* block_top,
+                        const std::int16_t* block_bottom, std::int16_t* distance, int count) {
+    for (int lane = 0; lane < count; ++lane) {
+        int best = BOARD_HEIGHT;
+        if (block_top[lane / LANE_BLOCK] > block_bottom[lane / LANE_BLOCK]) {
+            distance[lane] = static_cast<std::int16_t>(best);
+            continue;
+        }
+        for (int r = 0; r < 4; ++r) {
+            unsigned mask = piece_rows[r * stride + lane];
+            if (mask == 0) continue;
+            // Primeiro bloco abaixo desta linha da peça (ou o chão)
+            int y = cand_y[lane] + r + 1;
+            if (y < 0) y = 0;
+            while (y < BOARD_HEIGHT && (rows[y * stride + lane] & mask) == 0) ++y;
+            int d = y - (cand_y[lane] + r) - 1;
+            if (d < best) best = d;
+        }
+        distance[lane] = static_cast<std::int16_t>(best);
+    }
+}
+
+static void full_scalar(const std::uint16_t* rows, int stride, const std::int16_t* block_top,
+                        const std::int16_t* block_bottom, std::uint16_t* hits, int count) {
+    for (int lane = 0; lane < count; ++lane) {
+        bool full = false;
+        int block = lane / LANE_BLOCK;
+        for (int y = block_top[block]; y <= block_bottom[block]; ++y) full |= (rows[y * stride + lane] == FULL_ROW_MASK);
+        hits[lane] = full ? 1 : 0;
+    }
+}
+
+#if BATCH_HAS_X86_KERNELS
+__attribute__((target("sse2")))
+static void collide_sse2(const std::uint16_t* rows, int stride, const std::int16_t* cand_y,
+                         const std::uint16_t* piece_rows, const std::int16_t* block_top,
+                         const std::int16_t* block_bottom, std::uint16_t* hits, int count) {
+    for (int lane = 0; lane < count; lane += 8) {
+        int top = block_top[lane / LANE_BLOCK];
+        int bottom = block_bottom[lane / LANE_BLOCK];
+        if (top > bottom) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(hits + lane), _mm_setzero_si128());
+            continue;
+        }
+        __m128i py = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cand_y + lane));
+        __m128i pr[4];
+        for (int r = 0; r < 4; ++r) pr[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(piece_rows + r * stride + lane));
+        __m128i acc = _mm_setzero_si128();
+        for (int y = top; y <= bottom; ++y) {
+            __m128i local = _mm_sub_epi16(_mm_set1_epi16(static_cast<short>(y)), py);
+            __m128i m = _mm_setzero_si128();
+            for (int r = 0; r < 4; ++r) {
+                m = _mm_or_si128(m, _mm_and_si128(_mm_cmpeq_epi16(local, _mm_set1_epi16(static_cast<short>(r))), pr[r]));
+            }
+            __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + y * stride + lane));
+            acc = _mm_or_si128(acc, _mm_and_si128(row, m));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(hits + lane), acc);
+    }
+}
+
+// Desce de baixo para cima guardando, por linha da peça, o bloco mais alto
+// abaixo dela; a menor folga entre as quatro linhas é a distância da queda
+__attribute__((target("sse2")))
+static void drop_sse2(const std::uint16_t* rows, int stride, const std::int16_t* cand_y,
+                      const std::uint16_t* piece_rows, const std::int16_t* block_top,
+                      const std::int16_t* block_bottom, std::int16_t* distance, int count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i height = _mm_set1_epi16(BOARD_HEIGHT);
+    for (int lane = 0; lane < count; lane += 8) {
+        int block = lane / LANE_BLOCK;
+        if (block_top[block] > block_bottom[block]) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(distance + lane), height);
+            continue;
+        }
+        __m128i py = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cand_y + lane));
+        __m128i pr[4], top[4], first[4];
+        for (int r = 0; r < 4; ++r) {
+            pr[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(piece_rows + r * stride + lane));
+            top[r] = _mm_add_epi16(py, _mm_set1_epi16(static_cast<short>(r)));
+            first[r] = height;
+        }
+        for (int y = BOARD_HEIGHT - 1; y >= block_top[block]; --y) {
+            __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + y * stride + lane));
+            __m128i yv = _mm_set1_epi16(static_cast<short>(y));
+            for (int r = 0; r < 4; ++r) {
+                __m128i empty = _mm_cmpeq_epi16(_mm_and_si128(row, pr[r]), zero);
+                __m128i hit = _mm_andnot_si128(empty, _mm_cmpgt_epi16(yv, top[r]));
+                first[r] = _mm_or_si128(_mm_and_si128(hit, yv), _mm_andnot_si128(hit, first[r]));
+            }
+        }
+        __m128i best = height;
+        for (int r = 0; r < 4; ++r) {
+            __m128i d = _mm_sub_epi16(_mm_sub_epi16(first[r], top[r]), _mm_set1_epi16(1));
+            __m128i unused = _mm_cmpeq_epi16(pr[r], zero);
+            d = _mm_or_si128(_mm_and_si128(unused, height), _mm_andnot_si128(unused, d));
+            best = _mm_min_epi16(best, d);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(distance + lane), best);
+    }
+}
+
+__attribute__((target("sse2")))
+static void full_sse2(const std::uint16_t* rows, int stride, const std::int16_t* block_top,
+                      const std::int16_t* block_bottom, std::uint16_t* hits, int count) {
+    const __m128i full = _mm_set1_epi16(static_cast<short>(FULL_ROW_MASK));
+    for (int lane = 0; lane < count; lane += 8) {
+        __m128i acc = _mm_setzero_si128();
+        for (int y = block_top[lane / LANE_BLOCK]; y <= block_bottom[lane / LANE_BLOCK]; ++y) {
+            __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + y * stride + lane));
+            acc = _mm_or_si128(acc, _mm_cmpeq_epi16(row, full));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(hits + lane), acc);
+    }
+}
+
+__attribute__((target("avx2")))
+static void collide_avx2(const std::uint16_t* rows, int stride, const std::int16_t* cand_y,
+                         const std::uint16_t* piece_rows, const std::int16_t* block_top,
+                         const std::int16_t* block_bottom, std::uint16_t* hits, int count) {
+    for (int lane = 0; lane < count; lane += 16) {
+        int top = block_top[lane / LANE_BLOCK];
+        int bottom = block_bottom[lane / LANE_BLOCK];
+        if (top > bottom) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(hits + lane), _mm256_setzero_si256());
+            continue;
+        }
+        __m256i py = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cand_y + lane));
+        __m256i pr[4];
+        for (int r = 0; r < 4; ++r) pr[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(piece_rows + r * stride + lane));
+        __m256i acc = _mm256_setzero_si256();
+        for (int y = top; y <= bottom; ++y) {
+            __m256i local = _mm256_sub_epi16(_mm256_set1_epi16(static_cast<short>(y)), py);
+            __m256i m = _mm256_setzero_si256();
+            for (int r = 0; r < 4; ++r) {
+                m = _mm256_or_si256(m, _mm256_and_si256(_mm256_cmpeq_epi16(local, _mm256_set1_epi16(static_cast<short>(r))), pr[r]));
+            }
+            __m256i row = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + y * stride + lane));
+            acc = _mm256_or_si256(acc, _mm256_and_si256(row, m));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(hits + lane), acc);
+    }
+}
+
+__attribute__((target("avx2")))
+static void drop_avx2(const std::uint16_t* rows, int stride, const std::int16_t* cand_y,
+                      const std::uint16_t* piece_rows, const std::int16_t* block_top,
+                      const std::int16_t* block_bottom, std::int16_t* distance, int count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i height = _mm256_set1_epi16(BOARD_HEIGHT);
+    for (int lane = 0; lane < count; lane += 16) {
+        int block = lane / LANE_BLOCK;
+        if (block_top[block] > block_bottom[block]) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(distance + lane), height);
+            continue;
+        }
+        __m256i py = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cand_y + lane));
+        __m256i pr[4], top[4], first[4];
+        for (int r = 0; r < 4; ++r) {
+            pr[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(piece_rows + r * stride + lane));
+            top[r] = _mm256_add_epi16(py, _mm256_set1_epi16(static_cast<short>(r)));
+            first[r] = height;
+        }
+        for (int y = BOARD_HEIGHT - 1; y >= block_top[block]; --y) {
+            __m256i row = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + y * stride + lane));
+            __m256i yv = _mm256_set1_epi16(static_cast<short>(y));
+            for (int r = 0; r < 4; ++r) {
+                __m256i empty = _mm256_cmpeq_epi16(_mm256_and_si256(row, pr[r]), zero);
+                __m256i hit = _mm256_andnot_si256(empty, _mm256_cmpgt_epi16(yv, top[r]));
+                first[r] = _mm256_blendv_epi8(first[r], yv, hit);
+            }
+        }
+        __m256i best = height;
+        for (int r = 0; r < 4; ++r) {
+            __m256i d = _mm256_sub_epi16(_mm256_sub_epi16(first[r], top[r]), _mm256_set1_epi16(1));
+            d = _mm256_blendv_epi8(d, height, _mm256_cmpeq_epi16(pr[r], zero));
+            best = _mm256_min_epi16(best, d);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(distance + lane), best);
+    }
+}
+
+__attribute__((target("avx2")))
+static void full_avx2(const std::uint16_t* rows, int stride, const std::int16_t* block_top,
+                      const std::int16_t* block_bottom, std::uint16_t* hits, int count) {
+    const __m256i full = _mm256_set1_epi16(static_cast<short>(FULL_ROW_MASK));
+    for (int lane = 0; lane < count; lane += 16) {
+        __m256i acc = _mm256_setzero_si256();
+        for (int y = block_top[lane / LANE_BLOCK]; y <= block_bottom[lane / LANE_BLOCK]; ++y) {
+            __m256i row = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + y * stride + lane));
+            acc = _mm256_or_si256(acc, _mm256_cmpeq_epi16(row, full));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(hits + lane), acc);
+    }
+}
+#endif
+
+/// @brief Desloca a máscara de uma linha da peça para a coluna do tabuleiro
+static inline std::uint16_t shift_row_mask(unsigned row_mask, int piece_x) {
+    return static_cast<std::uint16_t>(piece_x >= 0 ? (row_mask << piece_x) : (row_mask >> -piece_x));
+}
+
+// ---------------------------------------------------------------------------
+// Preparação e aplicação dos candidatos
+//
+// prepare: a partir do comando de cada tabuleiro, calcula a posição candidata,
+//          as linhas da peça já deslocadas para os kernels (zeradas se o
+//          tabuleiro não age ou se a peça sai do tabuleiro) e a faixa de
+//          linhas de cada bloco
+// commit:  com os hits e as distâncias de queda dos kernels, move as peças e
+//          devolve os tabuleiros que fixam a peça e os giros bloqueados (que
+//          testam os kicks seguintes um a um, fora do lote)
+//
+// As ações de tabuleiros vizinhos não têm relação entre si, então nenhuma das
+// versões desvia por tabuleiro: um switch no comando erraria quase sempre. A
+// versão AVX2 lê a tabela das peças com gathers e desloca as linhas com os
+// shifts variáveis de 32 bits, 16 tabuleiros por vez; as outras usam a escalar.
+// ---------------------------------------------------------------------------
+
+// Candidato testado por cada comando, somado à posição atual. A rotação testa
+// primeiro o kick 0, que é sempre (0, 0); o hard drop testa a posição atual
+// (com o kernel de queda)
+static const std::int8_t COMMAND_DX[] = {0, -1, 1, 0, 0, 0};
+static const std::int8_t COMMAND_DY[] = {0, 0, 0, 0, 1, 0};
+static const std::int8_t COMMAND_TURN[] = {0, 0, 0, 1, 0, 0};
+
+static constexpr bool first_kicks_are_zero() {
+    for (int p = 0; p < 7; ++p) {
+        for (int r = 0; r < 4; ++r) {
+            if (PIECES.kicks[p][r][0].dx != 0 || PIECES.kicks[p][r][0].dy != 0) return false;
+        }
+    }
+    return true;
+}
+static_assert(first_kicks_are_zero(), "COMMAND_TURN testa a rotação sem deslocamento");
+
+// Peças indexadas por tipo * 4 + rotação. As 4 linhas vão num único inteiro
+// (linha r nos bits 16r a 16r + 15) e são deslocadas juntas para a coluna: com
+// a peça dentro do tabuleiro nenhum bit passa de uma linha para a outra
+struct CandidateTable {
+    std::uint64_t rows[28];
+    std::int32_t extent[28]; // min_x | max_x << 8 | min_y << 16 | max_y << 24
+};
+
+static constexpr CandidateTable make_candidate_table() {
+    CandidateTable t{};
+    for (int p = 0; p < 7; ++p) {
+        for (int r = 0; r < 4; ++r) {
+            const PieceMask& m = PIECES.masks[p][r];
+            for (int y = 0; y < 4; ++y) t.rows[p * 4 + r] |= static_cast<std::uint64_t>(m.rows[y]) << (16 * y);
+            t.extent[p * 4 + r] = m.min_x | m.max_x << 8 | m.min_y << 16 | m.max_y << 24;
+        }
+    }
+    return t;
+}
+
+static constexpr CandidateTable CANDIDATES = make_candidate_table();
+
+// Estado e rascunho de um step(), como os veem as funções abaixo
+struct BatchStepArrays {
+    const Command* actions;
+    const std::uint8_t* game_over;
+    const std::int16_t* piece_type;
+    std::int16_t* rotation;
+    std::int16_t* piece_x;
+    std::int16_t* piece_y;
+    std::uint8_t* active;
+    std::uint8_t* lines_cleared;
+    std::uint8_t* out_of_bounds;
+    std::int16_t* cand_x;
+    std::int16_t* cand_y;
+    std::int16_t* cand_rotation;
+    std::uint16_t* piece_rows;
+    const std::uint16_t* hits;
+    const std::int16_t* drop_distance;
+    int stride;
+};
+
+/// @brief Prepara o candidato de um tabuleiro e estende a faixa de linhas do bloco
+/// @return true se o tabuleiro pediu hard drop
+static inline bool prepare_lane(const BatchStepArrays& s, int lane, int& top, int& bottom) {
+    const int a = s.actions[lane];
+    const int act = (s.game_over[lane] == 0) & (a > CMD_NONE) & (a <= CMD_HARD_DROP);
+    const int cmd = a * act; // CMD_NONE se o tabuleiro não age
+    const int key = s.piece_type[lane] * 4 + ((s.rotation[lane] + COMMAND_TURN[cmd]) & 3);
+    const int x = s.piece_x[lane] + COMMAND_DX[cmd];
+    const int y = s.piece_y[lane] + COMMAND_DY[cmd];
+    const PieceMask& m = PIECES.masks[key / 4][key % 4];
+    const int oob = (x + m.min_x < 0) | (x + m.max_x >= BOARD_WIDTH) | (y + m.max_y >= BOARD_HEIGHT);
+    const int live = act & (oob ^ 1);
+
+    const std::uint64_t packed = CANDIDATES.rows[key];
+    const std::uint64_t shifted =
+        (x >= 0 ? packed << (x & 63) : packed >> (-x & 63)) & (0 - static_cast<std::uint64_t>(live));
+    for (int r = 0; r < 4; ++r) s.piece_rows[r * s.stride + lane] = static_cast<std::uint16_t>(shifted >> (16 * r));
+
+    s.active[lane] = static_cast<std::uint8_t>(act);
+    s.lines_cleared[lane] = 0;
+    s.out_of_bounds[lane] = static_cast<std::uint8_t>(oob);
+    s.cand_x[lane] = static_cast<std::int16_t>(x);
+    s.cand_y[lane] = static_cast<std::int16_t>(y);
+    s.cand_rotation[lane] = static_cast<std::int16_t>(key % 4);
+
+    // Como BatchEnv::include_rows(); sem peça viva o tabuleiro fica fora da faixa
+    const int row_top = std::max(y + m.min_y, 0);
+    const int row_bottom = std::max(y + m.max_y, row_top);
+    top = std::min(top, row_top + (live ^ 1) * BOARD_HEIGHT);
+    bottom = std::max(bottom, row_bottom - (live ^ 1) * 2 * BOARD_HEIGHT);
+    return cmd == CMD_HARD_DROP;
+}
+
+// Resultado de commit_lane()/commit_block_avx2()
+const int COMMIT_LOCK = 1; // A peça fixa no fim do step()
+const int COMMIT_KICK = 2; // Giro bloqueado no kick 0
+
+/// @brief Aplica o resultado dos kernels a um tabuleiro
+/// @return COMMIT_LOCK, COMMIT_KICK ou 0
+static inline int commit_lane(const BatchStepArrays& s, int lane) {
+    const int a = s.actions[lane];
+    const int act = s.active[lane];
+    const int blocked = s.out_of_bounds[lane] | (s.hits[lane] != 0);
+    const int drop = act & (a == CMD_HARD_DROP);
+    const int moved = act & (blocked ^ 1) & (drop ^ 1);
+    const int drop_y = s.piece_y[lane] + (drop ? s.drop_distance[lane] : 0);
+    s.piece_x[lane] = moved ? s.cand_x[lane] : s.piece_x[lane];
+    s.piece_y[lane] = static_cast<std::int16_t>(moved ? s.cand_y[lane] : drop_y);
+    s.rotation[lane] = moved ? s.cand_rotation[lane] : s.rotation[lane];
+
+    const int stuck = act & blocked;
+    return (drop | (stuck & (a == CMD_DOWN))) * COMMIT_LOCK | (stuck & (a == CMD_ROTATE)) * COMMIT_KICK;
+}
+
+#if BATCH_HAS_X86_KERNELS
+/// @brief 16 comandos (int) reduzidos a 16 bits, na ordem dos tabuleiros
+__attribute__((target("avx2")))
+static inline __m256i load_commands_avx2(const Command* actions) {
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(actions));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(actions + 8));
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+}
+
+/// @brief Dois vetores de 8 valores de 32 bits (sem sinal, < 2^16) reduzidos a um de 16 bits
+__attribute__((target("avx2")))
+static inline __m256i pack_u32_avx2(__m256i lo, __m256i hi) {
+    return _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i load_bytes_avx2(const std::uint8_t* bytes) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes)));
+}
+
+/// @brief Grava uma máscara de 16 bits por tabuleiro como um byte 0/1 por tabuleiro
+__attribute__((target("avx2")))
+static inline void store_flags_avx2(std::uint8_t* bytes, __m256i mask) {
+    __m128i packed = _mm_packs_epi16(_mm256_castsi256_si128(mask), _mm256_extracti128_si256(mask, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), _mm_and_si128(packed, _mm_set1_epi8(1)));
+}
+
+/// @brief Um bit por tabuleiro de uma máscara de 16 bits por tabuleiro
+__attribute__((target("avx2")))
+static inline unsigned lane_bits_avx2(__m256i mask) {
+    return static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_packs_epi16(_mm256_castsi256_si128(mask), _mm256_extracti128_si256(mask, 1))));
+}
+
+__attribute__((target("avx2")))
+static inline int min_epi16_avx2(__m256i v) {
+    __m128i m = _mm_min_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_min_epi16(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_min_epi16(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    m = _mm_min_epi16(m, _mm_shufflelo_epi16(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<std::int16_t>(_mm_extract_epi16(m, 0));
+}
+
+__attribute__((target("avx2")))
+static inline int max_epi16_avx2(__m256i v) {
+    __m128i m = _mm_max_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_max_epi16(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_max_epi16(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    m = _mm_max_epi16(m, _mm_shufflelo_epi16(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<std::int16_t>(_mm_extract_epi16(m, 0));
+}
+
+/// @brief Desloca 8 pares de linhas da peça (32 bits) para as colunas x, zerando os que não valem
+__attribute__((target("avx2")))
+static inline __m256i shift_rows_avx2(__m256i rows, __m256i x, __m256i live) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i left = _mm256_max_epi32(x, zero);
+    __m256i right = _mm256_max_epi32(_mm256_sub_epi32(zero, x), zero);
+    return _mm256_and_si256(_mm256_sllv_epi32(_mm256_srlv_epi32(rows, right), left), live);
+}
+
+/// @brief prepare_lane() para os 16 tabuleiros de um bloco
+/// @return true se algum deles pediu hard drop
+__attribute__((target("avx2")))
+static bool prepare_block_avx2(const BatchStepArrays& s, int lane, std::int16_t& block_top, std::int16_t& block_bottom) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i a = load_commands_avx2(s.actions + lane);
+    const __m256i act = _mm256_and_si256(
+        _mm256_cmpeq_epi16(load_bytes_avx2(s.game_over + lane), zero),
+        _mm256_and_si256(_mm256_cmpgt_epi16(a, _mm256_set1_epi16(CMD_NONE)),
+                         _mm256_cmpgt_epi16(_mm256_set1_epi16(CMD_HARD_DROP + 1), a)));
+    const __m256i cmd = _mm256_and_si256(a, act);
+
+    // As comparações valem -1: a esquerda soma -1, a direita subtrai -1, e assim por diante
+    const __m256i x = _mm256_add_epi16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.piece_x + lane)),
+        _mm256_sub_epi16(_mm256_cmpeq_epi16(cmd, _mm256_set1_epi16(CMD_LEFT)),
+                         _mm256_cmpeq_epi16(cmd, _mm256_set1_epi16(CMD_RIGHT))));
+    const __m256i y = _mm256_sub_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.piece_y + lane)),
+                                       _mm256_cmpeq_epi16(cmd, _mm256_set1_epi16(CMD_DOWN)));
+    const __m256i rot = _mm256_and_si256(
+        _mm256_sub_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.rotation + lane)),
+                         _mm256_cmpeq_epi16(cmd, _mm256_set1_epi16(CMD_ROTATE))),
+        _mm256_set1_epi16(3));
+    const __m256i key = _mm256_or_si256(
+        _mm256_slli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.piece_type + lane)), 2), rot);
+
+    // Tabela das peças: metade baixa e alta do bloco em 32 bits para os gathers
+    const __m256i key_lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(key));
+    const __m256i key_hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(key, 1));
+    const int* rows_table = reinterpret_cast<const int*>(CANDIDATES.rows);
+    const __m256i row_index_lo = _mm256_slli_epi32(key_lo, 1);
+    const __m256i row_index_hi = _mm256_slli_epi32(key_hi, 1);
+    __m256i rows01_lo = _mm256_i32gather_epi32(rows_table, row_index_lo, 4);
+    __m256i rows01_hi = _mm256_i32gather_epi32(rows_table, row_index_hi, 4);
+    __m256i rows23_lo = _mm256_i32gather_epi32(rows_table + 1, row_index_lo, 4);
+    __m256i rows23_hi = _mm256_i32gather_epi32(rows_table + 1, row_index_hi, 4);
+    const __m256i extent_lo = _mm256_i32gather_epi32(CANDIDATES.extent, key_lo, 4);
+    const __m256i extent_hi = _mm256_i32gather_epi32(CANDIDATES.extent, key_hi, 4);
+
+    const __m256i low16 = _mm256_set1_epi32(0xFFFF);
+    const __m256i low8 = _mm256_set1_epi16(0xFF);
+    const __m256i extent_x = pack_u32_avx2(_mm256_and_si256(extent_lo, low16), _mm256_and_si256(extent_hi, low16));
+    const __m256i extent_y = pack_u32_avx2(_mm256_srli_epi32(extent_lo, 16), _mm256_srli_epi32(extent_hi, 16));
+    const __m256i min_x = _mm256_and_si256(extent_x, low8);
+    const __m256i max_x = _mm256_srli_epi16(extent_x, 8);
+    const __m256i min_y = _mm256_and_si256(extent_y, low8);
+    const __m256i max_y = _mm256_srli_epi16(extent_y, 8);
+
+    const __m256i oob = _mm256_or_si256(
+        _mm256_cmpgt_epi16(zero, _mm256_add_epi16(x, min_x)),
+        _mm256_or_si256(_mm256_cmpgt_epi16(_mm256_add_epi16(x, max_x), _mm256_set1_epi16(BOARD_WIDTH - 1)),
+                        _mm256_cmpgt_epi16(_mm256_add_epi16(y, max_y), _mm256_set1_epi16(BOARD_HEIGHT - 1))));
+    const __m256i live = _mm256_andnot_si256(oob, act);
+
+    const __m256i x_lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(x));
+    const __m256i x_hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(x, 1));
+    const __m256i live_lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(live));
+    const __m256i live_hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(live, 1));
+    rows01_lo = shift_rows_avx2(rows01_lo, x_lo, live_lo);
+    rows01_hi = shift_rows_avx2(rows01_hi, x_hi, live_hi);
+    rows23_lo = shift_rows_avx2(rows23_lo, x_lo, live_lo);
+    rows23_hi = shift_rows_avx2(rows23_hi, x_hi, live_hi);
+
+    const __m256i rows[4] = {
+        pack_u32_avx2(_mm256_and_si256(rows01_lo, low16), _mm256_and_si256(rows01_hi, low16)),
+        pack_u32_avx2(_mm256_srli_epi32(rows01_lo, 16), _mm256_srli_epi32(rows01_hi, 16)),
+        pack_u32_avx2(_mm256_and_si256(rows23_lo, low16), _mm256_and_si256(rows23_hi, low16)),
+        pack_u32_avx2(_mm256_srli_epi32(rows23_lo, 16), _mm256_srli_epi32(rows23_hi, 16)),
+    };
+    for (int r = 0; r < 4; ++r) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.piece_rows + r * s.stride + lane), rows[r]);
+    }
+
+    store_flags_avx2(s.active + lane, act);
+    store_flags_avx2(s.out_of_bounds + lane, oob);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s.lines_cleared + lane), _mm_setzero_si128());
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.cand_x + lane), x);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.cand_y + lane), y);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s.cand_rotation + lane), rot);
+
+    const __m256i row_top = _mm256_max_epi16(_mm256_add_epi16(y, min_y), zero);
+    const __m256i row_bottom = _mm256_max_epi16(_mm256_add_epi16(y, max_y), row_top);
+    block_top = static_cast<std::int16_t>(
+        min_epi16_avx2(_mm256_blendv_epi8(_mm256_set1_epi16(BOARD_HEIGHT), row_top, live)));
+    block_bottom = static_cast<std::int16_t>(max_epi16_avx2(_mm256_blendv_epi8(_mm256_set1_epi16(-1), row_bottom, live)));
+    return lane_bits_avx2(_mm256_cmpeq_epi16(cmd, _mm256_set1_epi16(CMD_HARD_DROP))) != 0;
+}
+
+/// @brief commit_lane() para os 16 tabuleiros de um bloco
+/// @return Um bit por tabuleiro: os que fixam a peça nos bits 0-15, os giros bloqueados nos bits 16-31
+__attribute__((target("avx2")))
+static std::uint32_t commit_block_avx2(const BatchStepArrays& s, int lane) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i a = load_commands_avx2(s.actions + lane);
+    const __m256i act = _mm256_cmpgt_epi16(load_bytes_avx2(s.active + lane), zero);
+    const __m256i blocked = _mm256_or_si256(
+        _mm256_cmpgt_epi16(load_bytes_avx2(s.out_of_bounds + lane), zero),
+        _mm256_andnot_si256(_mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.hits + lane)), zero),
+                            _mm256_set1_epi16(-1)));
+    const __m256i drop = _mm256_and_si256(act, _mm256_cmpeq_epi16(a, _mm256_set1_epi16(CMD_HARD_DROP)));
+    const __m256i moved = _mm256_andnot_si256(_mm256_or_si256(blocked, drop), act);
+
+    std::int16_t* const targets[3] = {s.piece_x + lane, s.piece_y + lane, s.rotation + lane};
+    const std::int16_t* const candidates[3] = {s.cand_x + lane, s.cand_y + lane, s.cand_rotation + lane};
+    for (int i = 0; i < 3; ++i) {
+        __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(targets[i]));
+        if (i == 1) {
+            const __m256i distance = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.drop_distance + lane));
+            current = _mm256_add_epi16(current, _mm256_and_si256(distance, drop));
+        }
+        const __m256i candidate = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(candidates[i]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(targets[i]), _mm256_blendv_epi8(current, candidate, moved));
+    }
+
+    const __m256i stuck = _mm256_and_si256(act, blocked);
+    const __m256i lock = _mm256_or_si256(drop, _mm256_and_si256(stuck, _mm256_cmpeq_epi16(a, _mm256_set1_epi16(CMD_DOWN))));
+    const __m256i kick = _mm256_and_si256(stuck, _mm256_cmpeq_epi16(a, _mm256_set1_epi16(CMD_ROTATE)));
+    return lane_bits_avx2(lock) | lane_bits_avx2(kick) << 16;
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// BatchEnv
+// ---------------------------------------------------------------------------
+
+BatchEnv::BatchEnv(int num_lanes)
+    : num_lanes(num_lanes < 1 ? 1 : num_lanes),
+      stride((this->num_lanes + LANE_BLOCK - 1) / LANE_BLOCK * LANE_BLOCK),
+      rows(static_cast<std::size_t>(BOARD_HEIGHT) * stride, 0),
+      piece_type(stride, 0), rotation(stride, 0), piece_x(stride, 0), piece_y(stride, 0),
+      game_over(stride, 1), score(stride, 0), lines_cleared(stride, 0),
+      generators(stride),
+      active(stride, 0), cand_x(stride, 0), cand_y(stride, 0), cand_rotation(stride, 0),
+      piece_rows(4 * static_cast<std::size_t>(stride), 0), out_of_bounds(stride, 0),
+      hits(stride, 0), drop_distance(stride, 0),
+      block_top(stride / LANE_BLOCK, 0), block_bottom(stride / LANE_BLOCK, 0),
+      locking(stride, 0), num_locking(0),
+      kernel(best_kernel()) {
+    reset(1);
+}
+
+/// @brief Melhor kernel suportado pela CPU atual
+BatchKernel BatchEnv::best_kernel() {
+#if BATCH_HAS_X86_KERNELS
+    if (__builtin_cpu_supports("avx2")) return BATCH_KERNEL_AVX2;
+    return BATCH_KERNEL_SSE2;
+#else
+    return BATCH_KERNEL_SCALAR;
+#endif
+}
+
+const char* BatchEnv::kernel_name(BatchKernel kernel) {
+    switch (kernel) {
+    case BATCH_KERNEL_SSE2: return "sse2";
+    case BATCH_KERNEL_AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+BatchKernel BatchEnv::get_kernel() const {
+    return kernel;
+}
+
+/// @brief Força um kernel (para comparar os kernels entre si e com o Board)
+/// @return false se a CPU não suporta o kernel pedido (o atual é mantido)
+bool BatchEnv::set_kernel(BatchKernel kernel) {
+    if (kernel > best_kernel()) return false;
+    this->kernel = kernel;
+    return true;
+}
+
+/// @brief Reinicia todos os tabuleiros
+/// @param seed Seed do lote; o tabuleiro i usa player_seed(seed, i), como numa Match
+void BatchEnv::reset(std::uint32_t seed) {
+    for (int lane = 0; lane < num_lanes; ++lane) {
+        reset_lane(lane, player_seed(seed, lane));
+    }
+}
+
+/// @brief Reinicia um tabuleiro (mesmo estado que Player::reset com a mesma seed)
+void BatchEnv::reset_lane(int lane, std::uint32_t seed) {
+    for (int y = 0; y < BOARD_HEIGHT; ++y) rows[y * stride + lane] = 0;
+    game_over[lane] = 0;
+    score[lane] = 0;
+    lines_cleared[lane] = 0;
+    generators[lane].seed(seed);
+    spawn(lane); // Num tabuleiro vazio a peça nova nunca colide
+}
+
+/// @brief Coloca a próxima peça da fila do tabuleiro na posição de spawn
+void BatchEnv::spawn(int lane) {
+    int type = generators[lane].next();
+    piece_type[lane] = static_cast<std::int16_t>(type);
+    rotation[lane] = 0;
+    piece_x[lane] = static_cast<std::int16_t>(PIECES.spawn_x[type]);
+    piece_y[lane] = static_cast<std::int16_t>(PIECES.spawn_y[type]);
+}
+
+/// @brief Zera as faixas de linhas de todos os blocos antes de uma rodada
+void BatchEnv::clear_block_ranges() {
+    for (int block = 0; block < stride / LANE_BLOCK; ++block) {
+        block_top[block] = BOARD_HEIGHT;
+        block_bottom[block] = -1;
+    }
+}
+
+/// @brief Estende a faixa de linhas que os kernels olham no bloco do tabuleiro
+void BatchEnv::include_rows(int lane, int top, int bottom) {
+    int block = lane / LANE_BLOCK;
+    if (top < 0) top = 0;
+    if (bottom < top) bottom = top; // Peça inteira acima do topo ainda marca o bloco, para o hard drop
+    if (top < block_top[block]) block_top[block] = static_cast<std::int16_t>(top);
+    if (bottom > block_bottom[block]) block_bottom[block] = static_cast<std::int16_t>(bottom);
+}
+
+/// @brief Ponteiros para o estado e o rascunho, usados por prepare e commit
+BatchStepArrays BatchEnv::step_arrays(const Command* actions) {
+    return {actions, game_over.data(), piece_type.data(), rotation.data(), piece_x.data(), piece_y.data(),
+            active.data(), lines_cleared.data(), out_of_bounds.data(), cand_x.data(), cand_y.data(),
+            cand_rotation.data(), piece_rows.data(), hits.data(), drop_distance.data(), stride};
+}
+
+/// @brief Prepara os candidatos de todos os tabuleiros para os kernels
+/// @return true se algum tabuleiro pediu hard drop
+bool BatchEnv::prepare_candidates(const Command* actions) {
+    const BatchStepArrays arrays = step_arrays(actions);
+    bool any_drop = false;
+    for (int block = 0; block < stride / LANE_BLOCK; ++block) {
+        const int first = block * LANE_BLOCK;
+        const int end = std::min(num_lanes, first + LANE_BLOCK);
+#if BATCH_HAS_X86_KERNELS
+        if (kernel == BATCH_KERNEL_AVX2 && end - first == LANE_BLOCK) {
+            any_drop |= prepare_block_avx2(arrays, first, block_top[block], block_bottom[block]);
+            continue;
+        }
+#endif
+        int top = BOARD_HEIGHT;
+        int bottom = -1;
+        for (int lane = first; lane < end; ++lane) any_drop |= prepare_lane(arrays, lane, top, bottom);
+        block_top[block] = static_cast<std::int16_t>(top);
+        block_bottom[block] = static_cast<std::int16_t>(bottom);
+    }
+    return any_drop;
+}
+
+/// @brief Aplica o resultado dos kernels: move as peças, lista as que fixam e
+/// testa os kicks seguintes dos giros bloqueados
+void BatchEnv::commit_candidates(const Command* actions) {
+    const BatchStepArrays arrays = step_arrays(actions);
+    num_locking = 0;
+    for (int block = 0; block < stride / LANE_BLOCK; ++block) {
+        const int first = block * LANE_BLOCK;
+        const int end = std::min(num_lanes, first + LANE_BLOCK);
+#if BATCH_HAS_X86_KERNELS
+        if (kernel == BATCH_KERNEL_AVX2 && end - first == LANE_BLOCK) {
+            std::uint32_t bits = commit_block_avx2(arrays, first);
+            for (std::uint32_t lock = bits & 0xFFFF; lock != 0; lock &= lock - 1) {
+                locking[num_locking++] = first + __builtin_ctz(lock);
+            }
+            for (std::uint32_t kick = bits >> 16; kick != 0; kick &= kick - 1) {
+                rotate_with_kicks(first + __builtin_ctz(kick));
+            }
+            continue;
+        }
+#endif
+        for (int lane = first; lane < end; ++lane) {
+            int result = commit_lane(arrays, lane);
+            locking[num_locking] = lane;
+            num_locking += result & COMMIT_LOCK;
+            if (result & COMMIT_KICK) rotate_with_kicks(lane);
+        }
+    }
+}
+
+/// @brief Teste de colisão escalar de um tabuleiro (como Board::check_collision),
+/// para os poucos casos fora da rodada em lote (wall kicks seguintes e spawn)
+bool BatchEnv::collides_at(int lane, int x, int y, int rotation) const {
+    const PieceMask& m = PIECES.masks[piece_type[lane]][rotation];
+    if (x + m.min_x < 0 || x + m.max_x >= BOARD_WIDTH || y + m.max_y >= BOARD_HEIGHT) return true;
+    for (int r = m.min_y; r <= m.max_y; ++r) {
+        int board_y = y + r;
+        if (board_y >= 0 && (rows[board_y * stride + lane] & shift_row_mask(m.rows[r], x)) != 0) return true;
+    }
+    return false;
+}
+
+/// @brief Aplica um comando em cada tabuleiro (como Player::apply_command)
+/// @param actions Um comando por tabuleiro (tabuleiros em game over ignoram o seu)
+void BatchEnv::step(const Command* actions) {
+    // Uma única rodada de candidatos para todos os comandos: a casa vizinha para
+    // os movimentos, o primeiro wall kick para a rotação e a posição atual para o
+    // hard drop (que usa o kernel de queda em vez do de colisão)
+    bool any_drop = prepare_candidates(actions);
+    run_collide();
+    if (any_drop) run_drop();
+    commit_candidates(actions);
+    if (num_locking > 0) lock_pieces();
+}
+
+/// @brief Roda o kernel de colisão nas posições preparadas por prepare_candidates()
+void BatchEnv::run_collide() {
+    switch (kernel) {
+#if BATCH_HAS_X86_KERNELS
+    case BATCH_KERNEL_AVX2: collide_avx2(rows.data(), stride, cand_y.data(), piece_rows.data(), block_top.data(), block_bottom.data(), hits.data(), stride); break;
+    case BATCH_KERNEL_SSE2: collide_sse2(rows.data(), stride, cand_y.data(), piece_rows.data(), block_top.data(), block_bottom.data(), hits.data(), stride); break;
+#endif
+    default: collide_scalar(rows.data(), stride, cand_y.data(), piece_rows.data(), block_top.data(), block_bottom.data(), hits.data(), stride); break;
+    }
+}
+
+/// @brief Roda o kernel de distância de queda nas posições preparadas
+void BatchEnv::run_drop() {
+    switch (kernel) {
+#if BATCH_HAS_X86_KERNELS
+    case BATCH_KERNEL_AVX2: drop_avx2(rows.data(), stride, cand_y.data(), piece_rows.data(), block_top.data(), block_bottom.data(), drop_distance.data(), stride); break;
+    case BATCH_KERNEL_SSE2: drop_sse2(rows.data(), stride, cand_y.data(), piece_rows.data(), block_top.data(), block_bottom.data(), drop_distance.data(), stride); break;
+#endif
+    default: drop_scalar(rows.data(), stride, cand_y.data(), piece_rows.data(), block_top.data(), block_bottom.data(), drop_distance.data(), stride); break;
+    }
+}
+
+/// @brief Roda o kernel de linha completa nas faixas de linhas das peças recém-fixadas
+void BatchEnv::run_full() {
+    switch (kernel) {
+#if BATCH_HAS_X86_KERNELS
+    case BATCH_KERNEL_AVX2: full_avx2(rows.data(), stride, block_top.data(), block_bottom.data(), hits.data(), stride); break;
+    case BATCH_KERNEL_SSE2: full_sse2(rows.data(), stride, block_top.data(), block_bottom.data(), hits.data(), stride); break;
+#endif
+    default: full_scalar(rows.data(), stride, block_top.data(), block_bottom.data(), hits.data(), stride); break;
+    }
+}
+
+/// @brief Tenta os wall kicks depois do primeiro (que já falhou no kernel)
+void BatchEnv::rotate_with_kicks(int lane) {
+    int type = piece_type[lane];
+    int next_rotation = (rotation[lane] + 1) % 4;
+    for (int k = 1; k < PIECES.num_kicks[type]; ++k) {
+        const KickOffset& kick = PIECES.kicks[type][rotation[lane]][k];
+        int x = piece_x[lane] + kick.dx;
+        int y = piece_y[lane] + kick.dy;
+        if (!collides_at(lane, x, y, next_rotation)) {
+            piece_x[lane] = static_cast<std::int16_t>(x);
+            piece_y[lane] = static_cast<std::int16_t>(y);
+            rotation[lane] = static_cast<std::int16_t>(next_rotation);
+            return;
+        }
+    }
+}
+
+/// @brief Linha r de uma peça dentro do tabuleiro, já deslocada, e a linha do
+/// tabuleiro em que ela cai. Linhas da matriz 4x4 fora do tabuleiro ficam
+/// vazias e apontam para uma linha válida, para os laços abaixo não desviarem
+static inline int piece_row_at(int key, int x, int y, int r, std::uint16_t& mask) {
+    const std::uint64_t packed = CANDIDATES.rows[key];
+    const std::uint64_t shifted = x >= 0 ? packed << (x & 63) : packed >> (-x & 63);
+    const int board_y = y + r;
+    const bool inside = board_y >= 0 && board_y < BOARD_HEIGHT;
+    mask = inside ? static_cast<std::uint16_t>(shifted >> (16 * r)) : 0;
+    return inside ? board_y : 0;
+}
+
+/// @brief Fixa as peças dos tabuleiros em locking (como Player::lock_piece)
+void BatchEnv::lock_pieces() {
+    // "Queima" as peças; só as linhas delas podem ter ficado completas
+    clear_block_ranges();
+    for (int i = 0; i < num_locking; ++i) {
+        int lane = locking[i];
+        const int key = piece_type[lane] * 4 + rotation[lane];
+        for (int r = 0; r < 4; ++r) {
+            std::uint16_t mask;
+            int y = piece_row_at(key, piece_x[lane], piece_y[lane], r, mask);
+            rows[y * stride + lane] |= mask;
+        }
+        const PieceMask& m = PIECES.masks[piece_type[lane]][rotation[lane]];
+        include_rows(lane, piece_y[lane] + m.min_y, piece_y[lane] + m.max_y);
+    }
+    run_full();
+
+    for (int i = 0; i < num_locking; ++i) {
+        int lane = locking[i];
+
+        // Compactação (escalar, só nos tabuleiros que limparam linhas)
+        if (hits[lane] != 0) {
+            int write_y = BOARD_HEIGHT - 1;
+            int cleared = 0;
+            for (int y = BOARD_HEIGHT - 1; y >= 0; --y) {
+                std::uint16_t row = rows[y * stride + lane];
+                if (row == FULL_ROW_MASK) {
+                    cleared++;
+                    continue;
+                }
+                rows[write_y * stride + lane] = row;
+                write_y--;
+            }
+            for (int y = write_y; y >= 0; --y) rows[y * stride + lane] = 0;
+            lines_cleared[lane] = static_cast<std::uint8_t>(cleared);
+        }
+
+        // Próxima peça; se ela já nasce colidindo, o tabuleiro perdeu (e não pontua).
+        // O spawn fica sempre dentro das paredes, então basta olhar as linhas
+        spawn(lane);
+        const int key = piece_type[lane] * 4;
+        unsigned hit = 0;
+        for (int r = 0; r < 4; ++r) {
+            std::uint16_t mask;
+            int y = piece_row_at(key, piece_x[lane], piece_y[lane], r, mask);
+            hit |= rows[y * stride + lane] & mask;
+        }
+        game_over[lane] |= hit != 0;
+        score[lane] += hit != 0 ? 0 : score_for_lines(lines_cleared[lane]);
+    }
+}
+
+int BatchEnv::get_num_lanes() const {
+    return num_lanes;
+}
+
+std::uint16_t BatchEnv::get_row_mask(int lane, int y) const {
+    return rows[y * stride + lane];
+}
+
+int BatchEnv::get_piece_type(int lane) const {
+    return piece_type[lane];
+}
+
+int BatchEnv::get_piece_rotation(int lane) const {
+    return rotation[lane];
+}
+
+int BatchEnv::get_piece_x(int lane) const {
+    return piece_x[lane];
+}
+
+int BatchEnv::get_piece_y(int lane) const {
+    return piece_y[lane];
+}
+
+bool BatchEnv::is_game_over(int lane) const {
+    return game_over[lane] != 0;
+}
+
+int BatchEnv::get_score(int lane) const {
+    return score[lane];
+}
+
+int BatchEnv::get_lines_cleared(int lane) const {
+    return lines_cleared[lane];
+}
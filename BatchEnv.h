@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Player.h"
+#include "Random.h"
+#include <cstdint>
+#include <vector>
+
+struct BatchStepArrays;
+
+// Kernels de colisão, queda e linha completa usados pelo BatchEnv
+enum BatchKernel {
+    BATCH_KERNEL_SCALAR,
+    BATCH_KERNEL_SSE2,  // 8 tabuleiros por instrução
+    BATCH_KERNEL_AVX2   // 16 tabuleiros por instrução
+};
+
+// Ambiente em lote para treino e simulação em massa: K tabuleiros de um
+// jogador em layout de estrutura de arrays (a linha y de todos os tabuleiros
+// fica contígua), avançados juntos com um comando por tabuleiro a cada step().
+// Segue exatamente as regras de Player::apply_command (colisão, wall kicks,
+// hard drop, limpeza de linhas, pontuação, 7-bag com a mesma seed), sem
+// relógio, sem cores e sem lixo. Colisão, queda do hard drop e detecção de
+// linhas completas rodam para todos os tabuleiros de uma vez em kernels SIMD,
+// escolhidos em tempo de execução.
+class BatchEnv {
+public:
+    explicit BatchEnv(int num_lanes);
+
+    void reset(std::uint32_t seed); // Tabuleiro i recebe player_seed(seed, i)
+    void reset_lane(int lane, std::uint32_t seed);
+    void step(const Command* actions);
+
+    int get_num_lanes() const;
+    std::uint16_t get_row_mask(int lane, int y) const;
+    int get_piece_type(int lane) const;
+    int get_piece_rotation(int lane) const;
+    int get_piece_x(int lane) const;
+    int get_piece_y(int lane) const;
+    bool is_game_over(int lane) const;
+    int get_score(int lane) const;
+    int get_lines_cleared(int lane) const; // No último step()
+
+    BatchKernel get_kernel() const;
+    bool set_kernel(BatchKernel kernel); // false se a CPU não suporta
+    static BatchKernel best_kernel();
+    static const char* kernel_name(BatchKernel kernel);
+
+private:
+    int num_lanes;
+    int stride; // num_lanes arredondado para o bloco do maior kernel
+
+    // Estado, um elemento por tabuleiro (rows: rows[y * stride + lane])
+    std::vector<std::uint16_t> rows;
+    std::vector<std::int16_t> piece_type, rotation, piece_x, piece_y;
+    std::vector<std::uint8_t> game_over;
+    std::vector<int> score;
+    std::vector<std::uint8_t> lines_cleared;
+    std::vector<PieceGenerator> generators;
+
+    // Rascunho da rodada de testes de colisão
+    std::vector<std::uint8_t> active;
+    std::vector<std::int16_t> cand_x, cand_y, cand_rotation;
+    std::vector<std::uint16_t> piece_rows; // piece_rows[r * stride + lane]: linha r da peça já deslocada
+    std::vector<std::uint8_t> out_of_bounds;
+    std::vector<std::uint16_t> hits;
+    std::vector<std::int16_t> drop_distance;
+    std::vector<std::int16_t> block_top, block_bottom; // Linhas ocupadas pelas peças de cada bloco de 16
+    std::vector<int> locking; // Tabuleiros cuja peça fixa no fim do step()
+    int num_locking;
+
+    BatchKernel kernel;
+
+    void clear_block_ranges();
+    void include_rows(int lane, int top, int bottom);
+    BatchStepArrays step_arrays(const Command* actions);
+    bool prepare_candidates(const Command* actions);
+    void commit_candidates(const Command* actions);
+    void run_collide();
+    void run_drop();
+    void run_full();
+    bool collides_at(int lane, int x, int y, int rotation) const;
+    void rotate_with_kicks(int lane);
+    void spawn(int lane);
+    void lock_pieces();
+};
@@ -0,0 +1,472 @@
+#include "BatchEnv.h"
+#include "Match.h"
+#include "Perft.h"
+#include "Pieces.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Microbenchmarks dos caminhos quentes do Board e da vazão de partidas headless.
+// Todas as entradas vêm de seeds fixas, então duas execuções medem o mesmo trabalho.
+//
+// Uso: tetris_bench [--min-ms MS] [--filter TEXTO] [--save ARQUIVO]
+//                    [--baseline ARQUIVO] [--max-regress PCT]
+//
+// Antes de medir, o BatchEnv é conferido célula a célula contra Player/Board com
+// cada kernel suportado; uma divergência termina com código 4.
+//
+// --save grava os resultados ("nome valor unidade" por linha); --baseline
+// compara com um arquivo salvo antes e, com --max-regress, termina com código 3
+// se algum resultado piorou mais do que PCT por cento.
+
+struct BenchResult {
+    std::string name;
+    double value;
+    std::string unit; // "ns/op" (menor é melhor) ou "partidas/s" (maior é melhor)
+};
+
+// Impede o compilador de descartar resultados não usados
+static volatile long long bench_sink = 0;
+
+static long min_ms = 300;
+static const char* filter = nullptr;
+static std::vector<BenchResult> results;
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool selected(const char* name) {
+    return !filter || std::strstr(name, filter) != nullptr;
+}
+
+/// @brief Mede fn repetidamente, dobrando as iterações até passar de min_ms
+/// @param name Nome do benchmark
+/// @param fn Função que executa `iterations` operações e devolve um valor qualquer
+template <typename Fn>
+static void bench_ns(const char* name, Fn fn) {
+    if (!selected(name)) return;
+    fn(1000); // Aquecimento
+
+    long long iterations = 1000;
+    double seconds = 0.0;
+    while (true) {
+        auto start = std::chrono::steady_clock::now();
+        bench_sink = bench_sink + fn(iterations);
+        seconds = seconds_since(start);
+        if (seconds * 1000.0 >= static_cast<double>(min_ms)) break;
+        iterations *= 2;
+    }
+    double ns = seconds * 1e9 / static_cast<double>(iterations);
+    std::printf("%-28s %12.2f ns/op   (%lld ops)\n", name, ns, iterations);
+    results.push_back({name, ns, "ns/op"});
+}
+
+/// @brief Tabuleiro com uma pilha irregular, igual em toda execução
+static Board make_stacked_board(std::uint32_t seed, int height) {
+    Board board;
+    board.seed(seed);
+    board.initialize();
+    Xoshiro128 rng(seed);
+    for (int y = BOARD_HEIGHT - height; y < BOARD_HEIGHT; ++y) {
+        int hole = rng.below(BOARD_WIDTH);
+        for (int x = 0; x < BOARD_WIDTH; ++x) {
+            if (x != hole && rng.below(4) != 0) board.set_cell(x, y, 1 + rng.below(7));
+        }
+    }
+    board.spawn_piece(2); // T
+    return board;
+}
+
+/// @brief Tabuleiro em que uma I vertical na coluna 0 limpa exatamente `lines` linhas
+static Board make_clear_board(int lines) {
+    Board board;
+    board.seed(1);
+    board.initialize();
+    for (int y = BOARD_HEIGHT - 4; y < BOARD_HEIGHT; ++y) {
+        bool completes = y >= BOARD_HEIGHT - lines;
+        for (int x = 1; x < BOARD_WIDTH; ++x) {
+            if (completes || x != 5) board.set_cell(x, y, 8);
+        }
+    }
+    // I vertical: células na coluna local 1, então x = -1 encosta na parede
+    board.set_piece_state(PIECE_I, 1, -1, BOARD_HEIGHT - 4);
+    return board;
+}
+
+static void bench_board() {
+    struct Probe {
+        int x, y, rotation;
+    };
+    std::vector<Probe> probes;
+    Xoshiro128 rng(42);
+    for (int i = 0; i < 4096; ++i) {
+        probes.push_back({rng.below(BOARD_WIDTH + 2) - 2, rng.below(BOARD_HEIGHT), rng.below(4)});
+    }
+    const Board stacked = make_stacked_board(7, 12);
+
+    bench_ns("check_collision", [&](long long n) {
+        long long hits = 0;
+        for (long long i = 0; i < n; ++i) {
+            const Probe& p = probes[i & 4095];
+            hits += stacked.check_collision(p.x, p.y, p.rotation);
+        }
+        return hits;
+    });
+
+    bench_ns("move_piece", [&](long long n) {
+        Board board = stacked;
+        long long moved = 0;
+        for (long long i = 0; i < n; ++i) {
+            // Vai e volta na horizontal: metade dos movimentos bate na parede
+            moved += board.move_piece((i & 8) ? 1 : -1, 0);
+        }
+        return moved;
+    });
+
+    bench_ns("rotate_piece", [&](long long n) {
+        Board board = stacked;
+        long long rotated = 0;
+        for (long long i = 0; i < n; ++i) rotated += board.rotate_piece();
+        return rotated;
+    });
+
+    bench_ns("board_copy", [&](long long n) {
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            Board copy = stacked;
+            sum += copy.get_piece_x();
+        }
+        return sum;
+    });
+
+    // Jogar e desfazer: o padrão das buscas que reaproveitam um único tabuleiro
+    bench_ns("board_snapshot_restore", [&](long long n) {
+        Board board = stacked;
+        const BoardState saved = board.snapshot();
+        long long sum = 0;
+        for (long long i = 0; i < n; ++i) {
+            board.hard_drop();
+            sum += board.fix_piece_and_clear_lines() + board.get_holes();
+            board.restore(saved);
+        }
+        return sum;
+    });
+
+    // Busca em largura de todas as posições finais da peça atual (Perft.h)
+    bench_ns("enumerate_placements", [&](long long n) {
+        PlacementEnumerator enumerator;
+        static PiecePlacement placements[MAX_PIECE_STATES];
+        long long count = 0;
+        for (long long i = 0; i < n; ++i) count += enumerator.enumerate(stacked, placements);
+        return count;
+    });
+
+    // Cada operação inclui uma cópia do tabuleiro preparado (ver board_copy)
+    for (int lines = 0; lines <= 4; ++lines) {
+        const Board prepared = make_clear_board(lines);
+        std::string name = "fix_and_clear_" + std::to_string(lines);
+        bench_ns(name.c_str(), [&](long long n) {
+            long long cleared = 0;
+            for (long long i = 0; i < n; ++i) {
+                Board board = prepared;
+                cleared += board.fix_piece_and_clear_lines();
+            }
+            return cleared;
+        });
+    }
+
+    // Rajadas de ataques de 1 linha, inseridas num único lote
+    const Board empty = make_clear_board(0);
+    for (int burst : {1, 4, 8}) {
+        std::string name = "add_garbage_x" + std::to_string(burst);
+        GarbagePacket packets[8];
+        for (int i = 0; i < burst; ++i) packets[i] = {1, (i * 3) % BOARD_WIDTH};
+        bench_ns(name.c_str(), [&](long long n) {
+            long long sum = 0;
+            for (long long i = 0; i < n; ++i) {
+                Board board = empty;
+                board.add_garbage(packets, burst);
+                sum += board.get_row_mask(BOARD_HEIGHT - 1);
+            }
+            return sum;
+        });
+    }
+}
+
+/// @brief Partidas headless completas com seeds fixas, contando partidas por segundo
+/// @param name Nome do benchmark
+/// @param bot_depth 0 = comandos aleatórios; senão bots com essa profundidade
+/// @param max_ticks Limite de ticks por partida (bots bons não perdem sozinhos)
+static void bench_games(const char* name, int bot_depth, long max_ticks) {
+    if (!selected(name)) return;
+    static const Command COMMANDS[] = {CMD_NONE, CMD_LEFT, CMD_RIGHT, CMD_ROTATE, CMD_DOWN};
+
+    ThreadPool pool(1);
+    Bot bot(pool, bot_depth);
+    Match match(2, TARGET_NEXT);
+    long games = 0;
+    long long ticks = 0;
+    Xoshiro128 rng(2024);
+
+    auto start = std::chrono::steady_clock::now();
+    while (seconds_since(start) * 1000.0 < static_cast<double>(min_ms)) {
+        match.reset(0, static_cast<std::uint32_t>(games + 1));
+        for (long tick = 0; tick < max_ticks && !match.is_over(); ++tick) {
+            // Cada jogador age a cada 3 ticks (~50 ms), como no tetris_headless
+            if (tick % 3 == 0) {
+                for (int p = 0; p < 2; ++p) {
+                    if (bot_depth > 0) match.play_bot(p, bot, tick);
+                    else match.apply_command(p, COMMANDS[rng.below(5)], tick);
+                }
+            }
+            match.update(tick + 1);
+            ticks++;
+        }
+        games++;
+    }
+    double seconds = seconds_since(start);
+    double rate = games / seconds;
+    std::printf("%-28s %12.2f partidas/s (%ld partidas, %.0f ticks/s)\n", name, rate, games, ticks / seconds);
+    results.push_back({name, rate, "partidas/s"});
+}
+
+/// @brief Ações aleatórias com peso extra para hard drop
+static Command random_batch_action(Xoshiro128& rng) {
+    static const Command COMMANDS[] = {CMD_NONE, CMD_LEFT, CMD_RIGHT, CMD_ROTATE, CMD_DOWN, CMD_HARD_DROP, CMD_HARD_DROP};
+    return COMMANDS[rng.below(7)];
+}
+
+/// @brief Plano guloso para a peça atual (giros, movimentos e hard drop), para a
+/// validação chegar a limpar linhas com frequência
+/// @param plan Recebe os comandos em ordem inversa (o próximo fica no fim)
+static void plan_placement(const Board& board, std::vector<Command>& plan) {
+    int best_value = -1000000;
+    int best_rotation = 0;
+    int best_dx = 0;
+    for (int rotation = 0; rotation < 4; ++rotation) {
+        for (int dx = -BOARD_WIDTH; dx <= BOARD_WIDTH; ++dx) {
+            Board copy = board;
+            for (int i = 0; i < rotation; ++i) copy.rotate_piece();
+            int moved = 0;
+            while (moved != dx && copy.move_piece(dx < 0 ? -1 : 1, 0)) moved += dx < 0 ? -1 : 1;
+            if (moved != dx) continue;
+            copy.hard_drop();
+            int lines = copy.fix_piece_and_clear_lines();
+            int value = lines * 100 - copy.get_holes() * 40 - copy.get_aggregate_height() - copy.get_bumpiness();
+            if (value > best_value) {
+                best_value = value;
+                best_rotation = rotation;
+                best_dx = dx;
+            }
+        }
+    }
+    plan.clear();
+    plan.push_back(CMD_HARD_DROP);
+    for (int i = 0; i < (best_dx < 0 ? -best_dx : best_dx); ++i) plan.push_back(best_dx < 0 ? CMD_LEFT : CMD_RIGHT);
+    for (int i = 0; i < best_rotation; ++i) plan.push_back(CMD_ROTATE);
+}
+
+/// @brief Confere o BatchEnv contra Player/Board (mesmas seeds, mesmas ações) com um kernel
+/// @return false na primeira divergência (impressa em stderr)
+static bool validate_batch(BatchKernel kernel) {
+    const int lanes = 37; // Não múltiplo do bloco dos kernels, para exercitar as sobras
+    const int steps = 20000;
+    BatchEnv env(lanes);
+    env.set_kernel(kernel);
+    env.reset(99);
+    std::vector<Player> players(lanes);
+    for (int i = 0; i < lanes; ++i) players[i].reset(0, player_seed(99, i));
+
+    Xoshiro128 rng(5);
+    std::vector<Command> actions(lanes);
+    std::vector<std::vector<Command>> plans(lanes);
+    std::uint32_t next_seed = 1000;
+    long lines = 0;
+    for (int step = 0; step < steps; ++step) {
+        for (int i = 0; i < lanes; ++i) {
+            if (players[i].is_game_over()) {
+                // Recomeça o tabuleiro dos dois lados para continuar cobrindo estados novos
+                players[i].reset(0, next_seed);
+                plans[i].clear();
+                env.reset_lane(i, next_seed);
+                next_seed++;
+            }
+            // Metade dos tabuleiros joga pelo plano guloso (com 1 ação aleatória em 8),
+            // a outra metade só com ações aleatórias
+            if (i % 2 == 0 && rng.below(8) != 0) {
+                if (plans[i].empty()) plan_placement(players[i].get_board(), plans[i]);
+                actions[i] = plans[i].back();
+                plans[i].pop_back();
+            } else {
+                actions[i] = random_batch_action(rng);
+            }
+            StepResult result = players[i].apply_command(actions[i], 0);
+            lines += result.lines_cleared;
+            if (result.piece_fixed) plans[i].clear();
+        }
+        env.step(actions.data());
+
+        for (int i = 0; i < lanes; ++i) {
+            const Board& board = players[i].get_board();
+            bool same = env.is_game_over(i) == board.is_game_over() && env.get_score(i) == players[i].get_score() &&
+                        env.get_piece_type(i) == board.get_piece_type() &&
+                        env.get_piece_rotation(i) == board.get_piece_rotation() &&
+                        env.get_piece_x(i) == board.get_piece_x() && env.get_piece_y(i) == board.get_piece_y();
+            for (int y = 0; y < BOARD_HEIGHT && same; ++y) same = env.get_row_mask(i, y) == board.get_row_mask(y);
+            if (!same) {
+                std::fprintf(stderr, "BatchEnv (%s) diverge do Board no tabuleiro %d, step %d\n",
+                             BatchEnv::kernel_name(kernel), i, step);
+                return false;
+            }
+        }
+    }
+    std::printf("batch_validate_%-14s ok (%d steps x %d tabuleiros, %ld linhas)\n",
+                BatchEnv::kernel_name(kernel), steps, lanes, lines);
+    return true;
+}
+
+/// @brief Vazão do BatchEnv por kernel, em ns por tabuleiro-step, e a mesma
+/// carga num vetor de Player como referência
+static void bench_batch() {
+    const int lanes = 4096;
+    // Sequências de ações pré-sorteadas: o sorteio não entra na medida
+    std::vector<Command> actions(static_cast<std::size_t>(lanes) * 64);
+    Xoshiro128 rng(11);
+    for (Command& a : actions) a = random_batch_action(rng);
+
+    if (selected("batch_step_player")) {
+        std::vector<Player> players(lanes);
+        for (int i = 0; i < lanes; ++i) players[i].reset(0, player_seed(3, i));
+        bench_ns("batch_step_player", [&](long long n) {
+            long long steps = (n + lanes - 1) / lanes;
+            long long over = 0;
+            for (long long s = 0; s < steps; ++s) {
+                const Command* step_actions = actions.data() + (s & 63) * lanes;
+                for (int i = 0; i < lanes; ++i) {
+                    players[i].apply_command(step_actions[i], 0);
+                    if (players[i].is_game_over()) {
+                        players[i].reset(0, static_cast<std::uint32_t>(s * lanes + i));
+                        over++;
+                    }
+                }
+            }
+            return over;
+        });
+    }
+
+    for (int k = BATCH_KERNEL_SCALAR; k <= BatchEnv::best_kernel(); ++k) {
+        BatchKernel kernel = static_cast<BatchKernel>(k);
+        std::string name = std::string("batch_step_") + BatchEnv::kernel_name(kernel);
+        if (!selected(name.c_str())) continue;
+
+        BatchEnv env(lanes);
+        env.set_kernel(kernel);
+        env.reset(3);
+
+        bench_ns(name.c_str(), [&](long long n) {
+            long long steps = (n + lanes - 1) / lanes;
+            long long over = 0;
+            for (long long s = 0; s < steps; ++s) {
+                env.step(actions.data() + (s & 63) * lanes);
+                // Tabuleiros que perderam recomeçam, para o lote não esvaziar
+                for (int i = 0; i < lanes; ++i) {
+                    if (env.is_game_over(i)) {
+                        env.reset_lane(i, static_cast<std::uint32_t>(s * lanes + i));
+                        over++;
+                    }
+                }
+            }
+            return over;
+        });
+    }
+}
+
+static bool save_results(const char* path) {
+    std::FILE* file = std::fopen(path, "w");
+    if (!file) return false;
+    for (const BenchResult& r : results) {
+        std::fprintf(file, "%s %.4f %s\n", r.name.c_str(), r.value, r.unit.c_str());
+    }
+    return std::fclose(file) == 0;
+}
+
+/// @brief Compara com um baseline salvo por --save
+/// @return Maior piora encontrada, em porcentagem (0 se nada piorou)
+static double compare_baseline(const char* path) {
+    std::FILE* file = std::fopen(path, "r");
+    if (!file) {
+        std::fprintf(stderr, "Não foi possível abrir o baseline %s\n", path);
+        return 0.0;
+    }
+
+    std::printf("\n%-28s %12s %12s %9s\n", "comparacao", "baseline", "atual", "mudanca");
+    double worst = 0.0;
+    char name[128];
+    char unit[32];
+    double base = 0.0;
+    while (std::fscanf(file, "%127s %lf %31s", name, &base, unit) == 3) {
+        for (const BenchResult& r : results) {
+            if (r.name != name || r.unit != unit || base <= 0.0) continue;
+            // Positivo = melhorou, seja ns/op (menor) ou partidas/s (maior)
+            bool lower_is_better = r.unit == "ns/op";
+            double change = lower_is_better ? (base - r.value) / base * 100.0 : (r.value - base) / base * 100.0;
+            std::printf("%-28s %12.2f %12.2f %+8.1f%%\n", name, base, r.value, change);
+            if (-change > worst) worst = -change;
+        }
+    }
+    std::fclose(file);
+    return worst;
+}
+
+int main(int argc, char** argv) {
+    const char* save_path = nullptr;
+    const char* baseline_path = nullptr;
+    double max_regress = -1.0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Opção sem valor: %s\n", argv[i]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--min-ms") == 0) min_ms = std::atol(value);
+        else if (std::strcmp(argv[i - 1], "--filter") == 0) filter = value;
+        else if (std::strcmp(argv[i - 1], "--save") == 0) save_path = value;
+        else if (std::strcmp(argv[i - 1], "--baseline") == 0) baseline_path = value;
+        else if (std::strcmp(argv[i - 1], "--max-regress") == 0) max_regress = std::atof(value);
+        else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", argv[i - 1]);
+            return 1;
+        }
+    }
+
+#ifndef __OPTIMIZE__
+    std::printf("AVISO: compilado sem otimização; use -DCMAKE_BUILD_TYPE=Release\n");
+#endif
+
+    for (int k = BATCH_KERNEL_SCALAR; k <= BatchEnv::best_kernel(); ++k) {
+        if (!validate_batch(static_cast<BatchKernel>(k))) return 4;
+    }
+
+    bench_board();
+    bench_batch();
+    bench_games("games_random", 0, 300000);
+    bench_games("games_bot_depth1", 1, 6000);
+
+    if (save_path && !save_results(save_path)) {
+        std::fprintf(stderr, "Não foi possível gravar %s\n", save_path);
+        return 1;
+    }
+    if (baseline_path) {
+        double worst = compare_baseline(baseline_path);
+        if (max_regress >= 0.0 && worst > max_regress) {
+            std::printf("Regressão de %.1f%% acima do limite de %.1f%%\n", worst, max_regress);
+            return 3;
+        }
+    }
+    return 0;
+}
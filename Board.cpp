@@ -1,56 +1,59 @@
 #include "Board.h"
 #include "Constants.h"
-#include <cstdlib> // para rand()
-#include <ctime>   // para time()
-
-// Definição das 7 peças de Tetris (4 rotações cada)
-static const int TETROMINOES[7][4][4][4] = {
-    // I
-    {{{0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0}},
-     {{0,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,0,0}},
-     {{0,0,0,0}, {0,0,0,0}, {1,1,1,1}, {0,0,0,0}},
-     {{0,0,1,0}, {0,0,1,0}, {0,0,1,0}, {0,0,1,0}}},
-    // O
-    {{{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
-     {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
-     {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
-     {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}}},
-    // T
-    {{{0,0,0,0}, {1,1,1,0}, {0,1,0,0}, {0,0,0,0}},
-     {{0,1,0,0}, {1,1,0,0}, {0,1,0,0}, {0,0,0,0}},
-     {{0,1,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}},
-     {{0,1,0,0}, {0,1,1,0}, {0,1,0,0}, {0,0,0,0}}},
-    // S
-    {{{0,0,0,0}, {0,1,1,0}, {1,1,0,0}, {0,0,0,0}},
-     {{0,1,0,0}, {0,1,1,0}, {0,0,1,0}, {0,0,0,0}},
-     {{0,0,0,0}, {0,1,1,0}, {1,1,0,0}, {0,0,0,0}},
-     {{0,1,0,0}, {0,1,1,0}, {0,0,1,0}, {0,0,0,0}}},
-    // Z
-    {{{0,0,0,0}, {1,1,0,0}, {0,1,1,0}, {0,0,0,0}},
-     {{0,0,1,0}, {0,1,1,0}, {0,1,0,0}, {0,0,0,0}},
-     {{0,0,0,0}, {1,1,0,0}, {0,1,1,0}, {0,0,0,0}},
-     {{0,0,1,0}, {0,1,1,0}, {0,1,0,0}, {0,0,0,0}}},
-    // J
-    {{{0,0,0,0}, {1,0,0,0}, {1,1,1,0}, {0,0,0,0}},
-     {{0,1,1,0}, {0,1,0,0}, {0,1,0,0}, {0,0,0,0}},
-     {{0,0,0,0}, {1,1,1,0}, {0,0,1,0}, {0,0,0,0}},
-     {{0,1,0,0}, {0,1,0,0}, {1,1,0,0}, {0,0,0,0}}},
-    // L
-    {{{0,0,0,0}, {0,0,1,0}, {1,1,1,0}, {0,0,0,0}},
-     {{0,1,0,0}, {0,1,0,0}, {0,1,1,0}, {0,0,0,0}},
-     {{0,0,0,0}, {1,1,1,0}, {1,0,0,0}, {0,0,0,0}},
-     {{1,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,0,0,0}}}
-};
+#include "Pieces.h"
+#include <bit>     // para popcount()
+#include <random>  // para random_device
+#include <cstring> // para memcpy()/memmove()
+
+/// @brief Desloca a máscara de uma linha da peça para a coluna do tabuleiro
+/// @param row_mask Máscara local (4 bits) de uma linha da peça
+/// @param piece_x Coluna do canto superior esquerdo da peça (pode ser negativa)
+/// @return Máscara da linha nas colunas do tabuleiro
+static inline unsigned shift_row_mask(unsigned row_mask, int piece_x) {
+    return piece_x >= 0 ? (row_mask << piece_x) : (row_mask >> -piece_x);
+}
 
 Board::Board() : game_over(false) {
-    if (std::rand() == 0) { // Inicializa o seed uma vez
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
-    }
+    // Seed padrão diferente para cada tabuleiro; partidas reproduzíveis chamam seed() depois
+    seed(std::random_device{}());
     initialize();
 }
 
+/// @brief Reinicia os geradores aleatórios do tabuleiro
+/// @param seed Semente; a mesma semente gera a mesma sequência de peças e buracos
+void Board::seed(std::uint32_t seed) {
+    piece_generator.seed(seed);
+    garbage_random.seed(seed ^ 0x5BD1E995u);
+}
+
+/// @brief Consulta a fila de próximas peças sem retirá-las
+/// @param index Posição na fila (0 = a próxima a entrar)
+/// @return O índice do tipo de peça (0-6)
+int Board::get_next_piece(int index) const {
+    return piece_generator.peek(index);
+}
+
+const PieceGenerator& Board::get_piece_generator() const {
+    return piece_generator;
+}
+
+const Xoshiro128& Board::get_garbage_random() const {
+    return garbage_random;
+}
+
+void Board::set_random_state(const PieceGenerator& pieces, const Xoshiro128& garbage) {
+    piece_generator = pieces;
+    garbage_random = garbage;
+}
+
 void Board::initialize() {
-    grid.assign(BOARD_HEIGHT, std::vector<int>(BOARD_WIDTH, 0));
+    std::memset(rows, 0, sizeof(rows));
+    std::memset(color_planes, 0, sizeof(color_planes));
+    std::memset(heights, 0, sizeof(heights));
+    std::memset(column_holes, 0, sizeof(column_holes));
+    aggregate_height = 0;
+    total_holes = 0;
+    bumpiness = 0;
     game_over = false;
     spawn_new_piece();
 }
@@ -61,16 +64,22 @@ void Board::initialize() {
 /// @param x A coordenada X local (0-3) dentro da matriz 4x4 da peça
 /// @param y A coordenada Y local (0-3) dentro da matriz 4x4 da peça
 /// @return Retorna 1 se a célula [y][x] da peça[tipo][rotação] for um bloco, ou 0 se for uma célula vazia
-int Board::get_piece_block(int piece_type, int rotation, int x, int y) const {
-    return TETROMINOES[piece_type][rotation][y][x];
+int Board::get_piece_block(int piece_type, int rotation, int x, int y) {
+    return (PIECES.masks[piece_type][rotation].rows[y] >> x) & 1;
 }
 
-/// @brief Spawna uma peça aleatória
+/// @brief Spawna a próxima peça da fila (sequência 7-bag)
 void Board::spawn_new_piece() {
-    current_piece_type = std::rand() % 7;
+    spawn_piece(piece_generator.next());
+}
+
+/// @brief Spawna uma peça de tipo conhecido (usado pelas buscas do bot)
+/// @param piece_type O índice do tipo de peça (0-6)
+void Board::spawn_piece(int piece_type) {
+    current_piece_type = piece_type;
     current_rotation = 0;
-    current_x = BOARD_WIDTH / 2 - 2;
-    current_y = 0;
+    current_x = PIECES.spawn_x[piece_type];
+    current_y = PIECES.spawn_y[piece_type];
 
     if (check_collision(current_x, current_y, current_rotation)) {
         game_over = true;
@@ -89,22 +98,18 @@ bool Board::is_game_over() const {
 /// @param rotation O índice de rotação (0-3) da peça para testar
 /// @return Booleano se há uma colisão ou não
 bool Board::check_collision(int piece_x, int piece_y, int rotation) const {
-    for (int y = 0; y < 4; ++y) {
-        for (int x = 0; x < 4; ++x) {
-            if (get_piece_block(current_piece_type, rotation, x, y) != 0) {
-                int board_x = piece_x + x;
-                int board_y = piece_y + y;
-
-                // Fora dos limites (esquerda, direita, baixo)
-                if (board_x < 0 || board_x >= BOARD_WIDTH || board_y >= BOARD_HEIGHT) {
-                    return true;
-                }
-                
-                // Colisão com o grid (não checa o topo, y < 0)
-                if (board_y >= 0 && grid[board_y][board_x] != 0) {
-                    return true;
-                }
-            }
+    const PieceMask& m = PIECES.masks[current_piece_type][rotation];
+
+    // Fora dos limites (esquerda, direita, baixo)
+    if (piece_x + m.min_x < 0 || piece_x + m.max_x >= BOARD_WIDTH || piece_y + m.max_y >= BOARD_HEIGHT) {
+        return true;
+    }
+
+    // Colisão com o grid: um AND por linha ocupada (não checa o topo, y < 0)
+    for (int y = m.min_y; y <= m.max_y; ++y) {
+        int board_y = piece_y + y;
+        if (board_y >= 0 && (rows[board_y] & shift_row_mask(m.rows[y], piece_x)) != 0) {
+            return true;
         }
     }
     return false;
@@ -123,112 +128,309 @@ bool Board::move_piece(int dx, int dy) {
     return false;
 }
 
-/// @brief Rotaciona a peça
-void Board::rotate_piece() {
+/// @brief Rotaciona a peça no sentido horário, testando os wall kicks em ordem
+/// @return Booleano se foi possível rotacionar ou não
+bool Board::rotate_piece() {
     int next_rotation = (current_rotation + 1) % 4;
-    if (!check_collision(current_x, current_y, next_rotation)) {
-        current_rotation = next_rotation;
+    const KickOffset* kicks = PIECES.kicks[current_piece_type][current_rotation];
+    for (int k = 0; k < PIECES.num_kicks[current_piece_type]; ++k) {
+        int x = current_x + kicks[k].dx;
+        int y = current_y + kicks[k].dy;
+        if (!check_collision(x, y, next_rotation)) {
+            current_rotation = next_rotation;
+            current_x = x;
+            current_y = y;
+            return true;
+        }
     }
+    return false;
 }
 
 /// @brief Fixa uma peça que estava caindo e limpa as linhas
 /// @return Número de linhas que foram limpas
 int Board::fix_piece_and_clear_lines() {
-    // "Queima" a peça no grid
-    for (int y = 0; y < 4; ++y) {
-        for (int x = 0; x < 4; ++x) {
-            if (get_piece_block(current_piece_type, current_rotation, x, y) != 0) {
-                int board_x = current_x + x;
-                int board_y = current_y + y;
-                if (board_y >= 0 && board_y < BOARD_HEIGHT) {
-                    grid[board_y][board_x] = current_piece_type + 1; // +1 para cor
-                }
-            }
+    const PieceMask& m = PIECES.masks[current_piece_type][current_rotation];
+
+    // "Queima" a peça no grid; a cor é o tipo + 1, guardada como o tipo nos planos
+    bool any_full = false;
+    for (int y = m.min_y; y <= m.max_y; ++y) {
+        int board_y = current_y + y;
+        if (board_y < 0 || board_y >= BOARD_HEIGHT) continue;
+
+        std::uint16_t mask = static_cast<std::uint16_t>(shift_row_mask(m.rows[y], current_x));
+        rows[board_y] |= mask;
+        for (int p = 0; p < COLOR_PLANES; ++p) {
+            if ((current_piece_type >> p) & 1) color_planes[p][board_y] |= mask;
         }
+        if (rows[board_y] == FULL_ROW_MASK) any_full = true;
     }
 
-    // Limpa linhas
+    // Só as colunas tocadas pela peça mudam de altura ou de buracos
+    for (int x = m.min_x; x <= m.max_x; ++x) {
+        recompute_column(current_x + x);
+    }
+
+    // Só as linhas tocadas pela peça podem ter ficado completas
+    if (!any_full) return 0;
+
+    // Limpa linhas: compacta as linhas não completas para baixo numa única passada
     int lines_cleared = 0;
+    int top_cleared = BOARD_HEIGHT;
+    int write_y = BOARD_HEIGHT - 1;
     for (int y = BOARD_HEIGHT - 1; y >= 0; --y) {
-        bool line_full = true;
-        for (int x = 0; x < BOARD_WIDTH; ++x) {
-            if (grid[y][x] == 0) {
-                line_full = false;
-                break;
-            }
-        }
-
-        if (line_full) {
+        if (rows[y] == FULL_ROW_MASK) {
             lines_cleared++;
-            // Move todas as linhas acima para baixo
-            for (int r = y; r > 0; --r) {
-                grid[r] = grid[r - 1];
-            }
-            grid[0].assign(BOARD_WIDTH, 0); // Linha nova no topo
-            y++; // Checa a mesma linha novamente (agora com novos dados)
+            top_cleared = y;
+            continue;
         }
+        if (write_y != y) copy_row(write_y, y);
+        write_y--;
+    }
+
+    // Linhas novas no topo
+    clear_rows(0, lines_cleared);
+
+    // Colunas com blocos acima da linha completa mais alta só baixam (linhas completas
+    // não têm buracos); as que tinham o topo nela são recalculadas
+    for (int x = 0; x < BOARD_WIDTH; ++x) {
+        if (heights[x] > BOARD_HEIGHT - top_cleared) set_column(x, heights[x] - lines_cleared, column_holes[x]);
+        else recompute_column(x);
     }
     return lines_cleared;
 }
 
-/// @brief Adiciona o lixo enviado pelo outro jogador
-/// @param lines Número de linhas de lixo que vão ser adicionadas
-void Board::add_garbage(int lines) {
-    for (int i = 0; i < lines; ++i) {
-        // Checa se o topo está ocupado (game over)
-        for (int x = 0; x < BOARD_WIDTH; ++x) {
-            if (grid[0][x] != 0) {
-                game_over = true;
-                return;
-            }
-        }
+/// @brief Sorteia a coluna do buraco de um ataque que este tabuleiro vai enviar
+int Board::roll_garbage_hole() {
+    return garbage_random.below(BOARD_WIDTH);
+}
 
-        // Move tudo para cima
-        for (int y = 0; y < BOARD_HEIGHT - 1; ++y) {
-            grid[y] = grid[y + 1];
+/// @brief Adiciona um lote de ataques recebidos com um único deslocamento do grid
+/// @param packets Ataques na ordem de chegada (o último fica mais embaixo)
+/// @param count Número de ataques
+void Board::add_garbage(const GarbagePacket* packets, int count) {
+    // Cada ataque empurra o grid para cima; se ele empurrasse um bloco para fora
+    // do topo, o jogo acaba e só os ataques anteriores a ele entram
+    int total = 0;
+    int accepted = 0;
+    for (; accepted < count; ++accepted) {
+        int lines = packets[accepted].lines;
+        if (lines <= 0) continue;
+        if (total + lines > BOARD_HEIGHT) lines = BOARD_HEIGHT - total;
+        bool overflows = false;
+        for (int y = total; y < total + lines; ++y) overflows |= (rows[y] != 0);
+        if (overflows || lines <= 0) {
+            game_over = true;
+            break;
         }
-
-        // Adiciona linha de lixo (cor 8) com um buraco
-        grid[BOARD_HEIGHT - 1].assign(BOARD_WIDTH, 8);
-        grid[BOARD_HEIGHT - 1][std::rand() % BOARD_WIDTH] = 0;
+        total += lines;
     }
-}
+    if (total == 0) return;
 
-// ncurses
-void Board::draw(WINDOW* win) const {
-    werase(win);
-    box(win, 0, 0);
+    // Move tudo para cima de uma vez
+    std::memmove(rows, rows + total, (BOARD_HEIGHT - total) * sizeof(rows[0]));
+    for (std::uint16_t* plane : color_planes) {
+        std::memmove(plane, plane + total, (BOARD_HEIGHT - total) * sizeof(plane[0]));
+    }
 
-    // Desenha o grid
-    for (int y = 0; y < BOARD_HEIGHT; ++y) {
-        for (int x = 0; x < BOARD_WIDTH; ++x) {
-            if (grid[y][x] != 0) {
-                wattron(win, COLOR_PAIR(grid[y][x]));
-                mvwprintw(win, y + 1, x * 2 + 1, "[]");
-                wattroff(win, COLOR_PAIR(grid[y][x]));
-            }
+    // Linhas de lixo (cor 8) com o buraco de cada ataque
+    int hole_rows[BOARD_WIDTH] = {};
+    int row_hole[BOARD_HEIGHT];
+    int y = BOARD_HEIGHT - total;
+    for (int i = 0; i < accepted; ++i) {
+        int hole = packets[i].hole >= 0 ? packets[i].hole : roll_garbage_hole();
+        std::uint16_t mask = static_cast<std::uint16_t>(FULL_ROW_MASK & ~(1u << hole));
+        for (int line = 0; line < packets[i].lines && y < BOARD_HEIGHT; ++line, ++y) {
+            rows[y] = mask;
+            for (std::uint16_t* plane : color_planes) plane[y] = mask; // Cor 8: todos os bits
+            hole_rows[hole]++;
+            row_hole[y] = hole;
         }
     }
 
-    // Desenha a peça atual
-    for (int y = 0; y < 4; ++y) {
-        for (int x = 0; x < 4; ++x) {
-            if (get_piece_block(current_piece_type, current_rotation, x, y) != 0) {
-                int board_x = current_x + x;
-                int board_y = current_y + y;
-                if (board_y >= 0) {
-                    wattron(win, COLOR_PAIR(current_piece_type + 1));
-                    mvwprintw(win, board_y + 1, board_x * 2 + 1, "[]");
-                    wattroff(win, COLOR_PAIR(current_piece_type + 1));
-                }
-            }
+    // Colunas com blocos sobem `total` linhas e ganham como buracos os buracos do lixo
+    // que ficaram embaixo delas; nas vazias, o topo é a primeira linha de lixo sem
+    // buraco nelas, e os buracos abaixo dele contam
+    for (int x = 0; x < BOARD_WIDTH; ++x) {
+        if (heights[x] > 0) {
+            set_column(x, heights[x] + total, column_holes[x] + hole_rows[x]);
+            continue;
         }
+        int top = BOARD_HEIGHT - total;
+        while (top < BOARD_HEIGHT && row_hole[top] == x) top++;
+        set_column(x, BOARD_HEIGHT - top, top < BOARD_HEIGHT ? hole_rows[x] - (top - (BOARD_HEIGHT - total)) : 0);
     }
-    wrefresh(win);
 }
 
 /// @brief Chama a função de colisão, mas com a lógica de "cair 1"
 /// @return Mesma coisa da colisão
 bool Board::check_collision_on_drop() const {
     return check_collision(current_x, current_y + 1, current_rotation);
-}
\ No newline at end of file
+}
+
+/// @brief Quantas linhas a peça atual ainda pode cair: para cada coluna da peça,
+/// a distância da sua célula mais baixa até o primeiro bloco abaixo dela
+/// @return Distância de queda (0 se a peça já está apoiada)
+int Board::get_drop_distance() const {
+    const PieceMask& m = PIECES.masks[current_piece_type][current_rotation];
+    int distance = BOARD_HEIGHT;
+    for (int x = m.min_x; x <= m.max_x; ++x) {
+        int column = current_x + x;
+        int bottom_y = current_y + m.bottom[x];
+        // Acima do topo da coluna tudo está vazio: a altura dá a distância direto
+        int column_distance = (BOARD_HEIGHT - heights[column]) - bottom_y - 1;
+        if (column_distance < 0) {
+            // Peça embaixo de uma saliência: procura o primeiro bloco abaixo dela
+            unsigned column_bit = 1u << column;
+            int y = bottom_y + 1;
+            while (y < BOARD_HEIGHT && (y < 0 || (rows[y] & column_bit) == 0)) ++y;
+            column_distance = y - bottom_y - 1;
+        }
+        if (column_distance < distance) distance = column_distance;
+    }
+    return distance;
+}
+
+/// @brief Derruba a peça atual até onde ela encosta (sem fixá-la)
+/// @return Número de linhas que a peça caiu
+int Board::hard_drop() {
+    int distance = get_drop_distance();
+    current_y += distance;
+    return distance;
+}
+
+/// @brief Atualiza uma coluna e os totais que dependem dela
+/// @param x Coluna
+/// @param height Nova altura
+/// @param holes Novo número de buracos
+void Board::set_column(int x, int height, int holes) {
+    auto step = [this](int column) {
+        if (column <= 0 || column >= BOARD_WIDTH) return 0;
+        int diff = heights[column] - heights[column - 1];
+        return diff > 0 ? diff : -diff;
+    };
+    bumpiness -= step(x) + step(x + 1);
+    aggregate_height += height - heights[x];
+    total_holes += holes - column_holes[x];
+    heights[x] = static_cast<std::uint8_t>(height);
+    column_holes[x] = static_cast<std::uint8_t>(holes);
+    bumpiness += step(x) + step(x + 1);
+}
+
+/// @brief Recalcula altura e buracos de uma coluna a partir do bitboard
+void Board::recompute_column(int x) {
+    unsigned column_bit = 1u << x;
+    int height = 0;
+    int holes = 0;
+    for (int y = 0; y < BOARD_HEIGHT; ++y) {
+        if (rows[y] & column_bit) {
+            if (height == 0) height = BOARD_HEIGHT - y;
+        } else if (height > 0) {
+            holes++;
+        }
+    }
+    set_column(x, height, holes);
+}
+
+int Board::get_column_height(int x) const {
+    return heights[x];
+}
+
+int Board::get_column_holes(int x) const {
+    return column_holes[x];
+}
+
+int Board::get_row_fill(int y) const {
+    return std::popcount(static_cast<unsigned>(rows[y]));
+}
+
+int Board::get_aggregate_height() const {
+    return aggregate_height;
+}
+
+int Board::get_holes() const {
+    return total_holes;
+}
+
+int Board::get_bumpiness() const {
+    return bumpiness;
+}
+
+/// @brief Obtém a cor de uma célula fixa do tabuleiro
+/// @param x Coluna (0 a BOARD_WIDTH-1)
+/// @param y Linha (0 a BOARD_HEIGHT-1)
+/// @return Índice da cor da célula, ou 0 se estiver vazia
+int Board::get_cell(int x, int y) const {
+    if (((rows[y] >> x) & 1) == 0) return 0;
+    int color = 0;
+    for (int p = 0; p < COLOR_PLANES; ++p) color |= ((color_planes[p][y] >> x) & 1) << p;
+    return color + 1;
+}
+
+int Board::get_piece_type() const {
+    return current_piece_type;
+}
+
+int Board::get_piece_rotation() const {
+    return current_rotation;
+}
+
+int Board::get_piece_x() const {
+    return current_x;
+}
+
+int Board::get_piece_y() const {
+    return current_y;
+}
+
+std::uint16_t Board::get_row_mask(int y) const {
+    return rows[y];
+}
+
+/// @brief Define a cor de uma célula fixa, mantendo o bitboard coerente
+/// @param color Índice da cor, ou 0 para esvaziar a célula
+void Board::set_cell(int x, int y, int color) {
+    std::uint16_t bit = static_cast<std::uint16_t>(1u << x);
+    if (color != 0) rows[y] |= bit;
+    else rows[y] &= static_cast<std::uint16_t>(~bit);
+    for (int p = 0; p < COLOR_PLANES; ++p) {
+        if (color != 0 && (((color - 1) >> p) & 1)) color_planes[p][y] |= bit;
+        else color_planes[p][y] &= static_cast<std::uint16_t>(~bit);
+    }
+    recompute_column(x);
+}
+
+/// @brief Coloca a peça atual numa posição exata, sem checar colisão
+void Board::set_piece_state(int piece_type, int rotation, int x, int y) {
+    current_piece_type = piece_type;
+    current_rotation = rotation;
+    current_x = x;
+    current_y = y;
+}
+
+void Board::set_game_over(bool over) {
+    game_over = over;
+}
+
+/// @brief Guarda o estado completo do tabuleiro (peça, grid, geradores) com um memcpy
+BoardState Board::snapshot() const {
+    BoardState state;
+    std::memcpy(state.bytes, this, sizeof(Board));
+    return state;
+}
+
+/// @brief Volta exatamente ao estado guardado por snapshot()
+void Board::restore(const BoardState& state) {
+    std::memcpy(static_cast<void*>(this), state.bytes, sizeof(Board));
+}
+
+/// @brief Esvazia `count` linhas a partir de `first` (bitboard e cores)
+void Board::clear_rows(int first, int count) {
+    std::memset(rows + first, 0, count * sizeof(rows[0]));
+    for (std::uint16_t* plane : color_planes) std::memset(plane + first, 0, count * sizeof(plane[0]));
+}
+
+/// @brief Copia a linha `from` (bitboard e cores) para a linha `to`
+void Board::copy_row(int to, int from) {
+    rows[to] = rows[from];
+    for (std::uint16_t* plane : color_planes) plane[to] = plane[from];
+}
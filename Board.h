@@ -1,9 +1,22 @@
 #pragma once
 
-#include <vector>
-#include <ncurses.h>
+#include "Constants.h"
+#include "Random.h"
+#include <cstdint>
+#include <type_traits>
 
-class Board {
+// Um ataque de lixo: `lines` linhas com o buraco na mesma coluna
+struct GarbagePacket {
+    int lines;
+    int hole; // Coluna do buraco (-1 = sorteada por quem recebe)
+};
+
+struct BoardState;
+
+// Lógica pura do tabuleiro: não depende de terminal nem de threads.
+// Todo o estado fica dentro do objeto (sem heap), em 4 linhas de cache: copiar
+// um Board é um memcpy, e snapshot()/restore() guardam e voltam o estado inteiro.
+class alignas(64) Board {
 public:
     Board();
     void initialize();
@@ -12,23 +25,87 @@ public:
     // Métodos de lógica do jogo (chamados pelo player_thread)
     bool check_collision(int piece_x, int piece_y, int rotation) const;
     void spawn_new_piece();
+    void spawn_piece(int piece_type);
     bool move_piece(int dx, int dy);
-    void rotate_piece();
+    bool rotate_piece();
     int fix_piece_and_clear_lines();
-    void add_garbage(int lines);
+    void add_garbage(const GarbagePacket* packets, int count);
+    int roll_garbage_hole();
     bool check_collision_on_drop() const;
-    
-    // Método de renderização (chamado pelo render_thread)
-    void draw(WINDOW* win) const;
+    int get_drop_distance() const;
+    int hard_drop();
+
+    // Leitura do estado (usada pela renderização e pelos drivers headless)
+    int get_cell(int x, int y) const;
+    int get_piece_type() const;
+    int get_piece_rotation() const;
+    int get_piece_x() const;
+    int get_piece_y() const;
+
+    static int get_piece_block(int piece_type, int rotation, int x, int y);
+
+    // Características da superfície, mantidas a cada alteração do grid (O(1) para ler)
+    int get_column_height(int x) const; // 0 = coluna vazia
+    int get_column_holes(int x) const;  // Células vazias abaixo do topo da coluna
+    int get_row_fill(int y) const;      // Células ocupadas da linha
+    int get_aggregate_height() const;
+    int get_holes() const;
+    int get_bumpiness() const;          // Soma das diferenças de altura entre colunas vizinhas
+
+    // Aleatoriedade própria do tabuleiro, reproduzível pela seed. As peças e os
+    // buracos do lixo usam geradores separados: com a mesma seed, dois jogadores
+    // recebem a mesma sequência de peças, não importa quanto lixo cada um tome.
+    void seed(std::uint32_t seed);
+    int get_next_piece(int index) const; // index < PREVIEW_SIZE
+    const PieceGenerator& get_piece_generator() const;
+    const Xoshiro128& get_garbage_random() const;
+    void set_random_state(const PieceGenerator& pieces, const Xoshiro128& garbage);
+
+    // Restauração do estado completo (usada pelos keyframes de replay)
+    std::uint16_t get_row_mask(int y) const;
+    void set_cell(int x, int y, int color);
+    void set_piece_state(int piece_type, int rotation, int x, int y);
+    void set_game_over(bool over);
+
+    // Estado completo numa cópia crua (buscas, desfazer, análises "e se")
+    BoardState snapshot() const;
+    void restore(const BoardState& state);
 
 private:
-    std::vector<std::vector<int>> grid;
+    // Bitboard: uma máscara por linha, o bit x representa a coluna x
+    std::uint16_t rows[BOARD_HEIGHT];
+    // Cor das células ocupadas, menos 1 (cores 1 a 8), em planos de bits: o bit x
+    // da linha y no plano p é o bit p da cor da célula (x, y)
+    static const int COLOR_PLANES = 3;
+    std::uint16_t color_planes[COLOR_PLANES][BOARD_HEIGHT];
     bool game_over;
 
+    // Características incrementais (ver recompute_column/set_column)
+    std::uint8_t heights[BOARD_WIDTH];
+    std::uint8_t column_holes[BOARD_WIDTH];
+    std::int16_t aggregate_height;
+    std::int16_t total_holes;
+    std::int16_t bumpiness;
+
+    void set_column(int x, int height, int holes);
+    void recompute_column(int x);
+
     // Estado da peça atual
-    int current_piece_type;
-    int current_rotation;
-    int current_x, current_y;
+    std::int8_t current_piece_type;
+    std::int8_t current_rotation;
+    std::int8_t current_x, current_y;
+
+    PieceGenerator piece_generator;
+    Xoshiro128 garbage_random;
+
+    void clear_rows(int first, int count);
+    void copy_row(int to, int from);
+};
+
+static_assert(std::is_trivially_copyable_v<Board>, "Board precisa ser copiável com memcpy");
+static_assert(sizeof(Board) <= 4 * 64, "Board deve caber em 4 linhas de cache");
 
-    int get_piece_block(int piece_type, int rotation, int x, int y) const;
-};
\ No newline at end of file
+// Bytes de um Board, guardados por snapshot() e devolvidos por restore()
+struct BoardState {
+    alignas(Board) unsigned char bytes[sizeof(Board)];
+};
@@ -0,0 +1,167 @@
+#include "Bot.h"
+#include <limits>
+
+// Valor de um tabuleiro em que o jogador perdeu
+static const double LOST_VALUE = -1e9;
+
+/// @brief Leva a peça atual de uma cópia do tabuleiro até a posição pedida e a derruba,
+/// usando os mesmos movimentos que execute() aplica no jogo
+/// @param board Cópia do tabuleiro (modificada)
+/// @param rotation Número de rotações a partir do spawn
+/// @param x Coluna final desejada
+/// @return false se a posição não é alcançável
+static bool drop_piece_at(Board& board, int rotation, int x) {
+    for (int r = 0; r < rotation; ++r) {
+        board.rotate_piece();
+    }
+    if (board.get_piece_rotation() != rotation) return false;
+
+    int dx = (x > board.get_piece_x()) ? 1 : -1;
+    while (board.get_piece_x() != x) {
+        if (!board.move_piece(dx, 0)) return false;
+    }
+    board.hard_drop();
+    return true;
+}
+
+/// @brief Heurística de avaliação de um tabuleiro (quanto maior, melhor)
+/// @param board Tabuleiro depois de fixar a peça
+/// @param lines_cleared Linhas limpas no caminho até esse tabuleiro
+/// @param weights Pesos de cada característica
+/// @return Valor do tabuleiro
+double evaluate_board(const Board& board, int lines_cleared, const BotWeights& weights) {
+    // Altura, buracos e irregularidade são mantidos pelo próprio Board
+    return weights.height * board.get_aggregate_height() + weights.lines * lines_cleared +
+           weights.holes * board.get_holes() + weights.bumpiness * board.get_bumpiness();
+}
+
+Bot::Bot(ThreadPool& pool, int depth, const BotWeights& weights)
+    : pool(&pool), depth(depth < 1 ? 1 : depth), weights(weights) {}
+
+Bot::Bot(int depth, const BotWeights& weights) : pool(nullptr), depth(depth < 1 ? 1 : depth), weights(weights) {}
+
+int Bot::get_depth() const {
+    return depth;
+}
+
+const BotWeights& Bot::get_weights() const {
+    return weights;
+}
+
+/// @brief Melhor valor alcançável colocando a peça atual do tabuleiro
+/// @param board Tabuleiro com a peça a ser colocada
+/// @param depth_left Peças que ainda faltam colocar, incluindo a atual
+/// @param lines_so_far Linhas limpas até aqui
+/// @param preview_index Posição na fila de preview da peça seguinte a esta
+double Bot::best_value(const Board& board, int depth_left, int lines_so_far, int preview_index) const {
+    double best = LOST_VALUE;
+    for (int rotation = 0; rotation < 4; ++rotation) {
+        for (int x = -2; x < BOARD_WIDTH; ++x) {
+            Board next = board;
+            if (!drop_piece_at(next, rotation, x)) continue;
+            int lines = lines_so_far + next.fix_piece_and_clear_lines();
+            double value = (depth_left <= 1) ? evaluate_board(next, lines, weights)
+                                             : expected_value(next, depth_left - 1, lines, preview_index);
+            if (value > best) best = value;
+        }
+    }
+    return best;
+}
+
+/// @brief Valor esperado de um tabuleiro antes da próxima peça. Se ela está na
+/// fila de preview, é só o melhor valor com ela; senão, média sobre os 7 tipos,
+/// cada um calculado numa tarefa do pool
+/// @param board Tabuleiro sem peça ativa (logo após fixar)
+/// @param depth_left Peças que ainda faltam colocar
+/// @param lines_so_far Linhas limpas até aqui
+/// @param preview_index Posição da próxima peça na fila de preview do tabuleiro
+double Bot::expected_value(const Board& board, int depth_left, int lines_so_far, int preview_index) const {
+    // As cópias do tabuleiro nunca consomem a fila (spawn_piece), então ela ainda
+    // é a do tabuleiro original
+    if (preview_index < PREVIEW_SIZE) {
+        Board next = board;
+        next.spawn_piece(board.get_next_piece(preview_index));
+        return next.is_game_over() ? LOST_VALUE : best_value(next, depth_left, lines_so_far, preview_index + 1);
+    }
+
+    double values[7];
+    TaskGroup group(pool);
+    for (int piece = 0; piece < 7; ++piece) {
+        auto task = [this, &board, &values, piece, depth_left, lines_so_far, preview_index] {
+            Board next = board;
+            next.spawn_piece(piece);
+            values[piece] = next.is_game_over() ? LOST_VALUE : best_value(next, depth_left, lines_so_far, preview_index + 1);
+        };
+        // O último nível é barato demais para valer uma tarefa
+        if (depth_left > 1) group.run(task);
+        else task();
+    }
+    group.wait();
+
+    double total = 0.0;
+    for (double v : values) total += v;
+    return total / 7.0;
+}
+
+/// @brief Escolhe a melhor posição para a peça atual. Cada posição do primeiro
+/// nível vira uma tarefa; os níveis seguintes criam subtarefas que os workers
+/// ociosos roubam
+/// @param board Tabuleiro atual (não é modificado)
+/// @return Posição escolhida (valid = false se nenhuma é alcançável)
+Placement Bot::choose(const Board& board) const {
+    const int num_x = BOARD_WIDTH + 2;
+    Placement candidates[4][BOARD_WIDTH + 2];
+
+    TaskGroup group(pool);
+    for (int rotation = 0; rotation < 4; ++rotation) {
+        for (int i = 0; i < num_x; ++i) {
+            auto task = [this, &board, &candidates, rotation, i] {
+                Placement& p = candidates[rotation][i];
+                p.rotation = rotation;
+                p.x = i - 2;
+                Board next = board;
+                if (!drop_piece_at(next, rotation, p.x)) return;
+                int lines = next.fix_piece_and_clear_lines();
+                p.score = (depth <= 1) ? evaluate_board(next, lines, weights) : expected_value(next, depth - 1, lines, 0);
+                p.valid = true;
+            };
+            // Sem lookahead cada posição custa só uma avaliação: não vale uma tarefa
+            if (depth > 1) group.run(task);
+            else task();
+        }
+    }
+    group.wait();
+
+    Placement best;
+    best.score = -std::numeric_limits<double>::infinity();
+    for (int rotation = 0; rotation < 4; ++rotation) {
+        for (int i = 0; i < num_x; ++i) {
+            const Placement& p = candidates[rotation][i];
+            if (p.valid && p.score > best.score) best = p;
+        }
+    }
+    return best;
+}
+
+/// @brief Aplica no jogador os comandos que levam a peça até a posição escolhida
+/// e a fixam (gira, anda e faz o hard drop)
+/// @param player Jogador controlado pelo bot
+/// @param placement Posição escolhida por choose()
+/// @param tick Tick atual
+/// @return Resultado da fixação, com o lixo a ser enviado
+StepResult Bot::execute(Player& player, const Placement& placement, long tick) {
+    Board& board = player.get_board();
+    if (placement.valid) {
+        for (int r = 0; r < placement.rotation; ++r) {
+            player.apply_command(CMD_ROTATE, tick);
+        }
+        Command side = (placement.x > board.get_piece_x()) ? CMD_RIGHT : CMD_LEFT;
+        while (board.get_piece_x() != placement.x) {
+            int before = board.get_piece_x();
+            player.apply_command(side, tick);
+            if (board.get_piece_x() == before) break;
+        }
+    }
+
+    return player.apply_command(CMD_HARD_DROP, tick);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Player.h"
+#include "ThreadPool.h"
+
+// Posição final escolhida pelo bot para a peça atual
+struct Placement {
+    int rotation = 0;
+    int x = 0;
+    double score = 0.0;
+    bool valid = false;
+};
+
+// Pesos da heurística de avaliação (os padrões foram ajustados por algoritmo genético)
+struct BotWeights {
+    double height = -0.510066;   // Altura agregada
+    double lines = 0.760666;     // Linhas limpas
+    double holes = -0.35663;     // Buracos
+    double bumpiness = -0.184483; // Irregularidade da superfície
+};
+
+// Jogador automático: enumera todas as posições alcançáveis da peça atual
+// (girando no spawn, andando na horizontal e caindo até encostar) e das
+// próximas peças, avalia os tabuleiros resultantes com uma heurística e
+// escolhe a melhor. Enquanto a busca está dentro da fila de preview, a próxima
+// peça é conhecida; além dela, cada nível de lookahead tira a média sobre os 7
+// tipos possíveis. A busca é dividida em tarefas no ThreadPool, então a
+// profundidade alcançável cresce com os núcleos. Sem pool, a busca roda inteira
+// na thread de quem chama (muitas partidas em paralelo, como nos torneios).
+class Bot {
+public:
+    Bot(ThreadPool& pool, int depth, const BotWeights& weights = BotWeights());
+    explicit Bot(int depth, const BotWeights& weights = BotWeights());
+
+    Placement choose(const Board& board) const;
+    static StepResult execute(Player& player, const Placement& placement, long tick);
+
+    int get_depth() const;
+    const BotWeights& get_weights() const;
+
+private:
+    ThreadPool* pool; // nullptr = busca serial
+    int depth;        // Número de peças consideradas (1 = só a atual)
+    BotWeights weights;
+
+    double best_value(const Board& board, int depth_left, int lines_so_far, int preview_index) const;
+    double expected_value(const Board& board, int depth_left, int lines_so_far, int preview_index) const;
+};
+
+double evaluate_board(const Board& board, int lines_cleared, const BotWeights& weights = BotWeights());
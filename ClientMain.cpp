@@ -0,0 +1,264 @@
+#include "Random.h"
+#include "ServerProtocol.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+// Cliente de carga do tetris_server: simula muitos jogadores num único processo.
+//
+// Uso: tetris_client [--socket CAMINHO] [--clients N] [--players P]
+//                    [--rate R] [--duration S] [--seed S]
+//
+// Abre --clients conexões, cada uma pedindo partidas de --players jogadores,
+// e manda --rate comandos aleatórios por segundo em cada uma. Todas as
+// conexões são atendidas por uma thread com epoll. Cada MSG_STATE é aplicada
+// sobre a cópia local dos tabuleiros, como faria um cliente de verdade.
+// Quando uma partida acaba, o cliente pede outra, até passarem --duration
+// segundos. No fim imprime o volume recebido e a latência entre um comando e
+// o primeiro estado que mostra o próprio tabuleiro mudando.
+
+static const Command RANDOM_COMMANDS[] = {CMD_LEFT, CMD_RIGHT, CMD_ROTATE, CMD_DOWN, CMD_LEFT, CMD_RIGHT, CMD_ROTATE,
+                                          CMD_HARD_DROP};
+
+struct Client {
+    int fd = -1;
+    FrameParser parser;
+    std::vector<BoardSnapshot> boards; // Estado local de todos os jogadores da partida
+    int seat = -1;
+    bool playing = false;
+    long long next_input_ns = 0;
+    long long pending_ns = 0; // Envio do comando ainda sem estado correspondente (0 = nenhum)
+};
+
+struct ClientStats {
+    long long matches = 0;
+    long long wins = 0;
+    long long states = 0;
+    long long bytes = 0;
+    long long inputs = 0;
+    long long errors = 0; // Mensagens mal formadas ou conexões perdidas
+    std::vector<long long> latency_ns;
+};
+
+static long long now_ns() {
+    return SimClock::steady_ns();
+}
+
+/// @brief Conecta ao servidor. O socket fica bloqueante: só é lido depois que o
+/// epoll avisa, e os envios usam MSG_DONTWAIT
+static int connect_server(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// @brief Manda mensagens curtas; se o socket estiver cheio, descarta (o servidor está atrasado)
+static bool send_all(int fd, const std::vector<std::uint8_t>& bytes) {
+    ssize_t n = send(fd, bytes.data(), bytes.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    return n == static_cast<ssize_t>(bytes.size());
+}
+
+static void send_join(Client& client, int num_players) {
+    std::vector<std::uint8_t> out;
+    MessageWriter writer(out);
+    writer.begin(MSG_JOIN);
+    writer.u16(SERVER_PROTOCOL_VERSION);
+    writer.u8(static_cast<std::uint8_t>(num_players));
+    writer.end();
+    send_all(client.fd, out);
+}
+
+/// @brief Processa uma mensagem do servidor
+/// @return false se a mensagem é inválida
+static bool handle_message(Client& client, MessageType type, const std::uint8_t* body, std::size_t size,
+                           ClientStats& stats, bool rejoin, int num_players) {
+    MessageReader reader(body, size);
+    if (type == MSG_START) {
+        std::uint32_t match;
+        std::uint32_t seed;
+        std::uint8_t seat;
+        std::uint8_t players;
+        if (!reader.u32(match) || !reader.u32(seed) || !reader.u8(seat) || !reader.u8(players)) return false;
+        client.boards.assign(players, BoardSnapshot{});
+        client.seat = seat;
+        client.playing = true;
+        client.pending_ns = 0;
+        return true;
+    }
+    if (type == MSG_STATE) {
+        if (!client.playing) return false;
+        long tick;
+        std::uint32_t version = client.boards[client.seat].version;
+        if (!decode_state_delta(reader, tick, client.boards)) return false;
+        stats.states++;
+        if (client.pending_ns != 0 && client.boards[client.seat].version != version) {
+            stats.latency_ns.push_back(now_ns() - client.pending_ns);
+            client.pending_ns = 0;
+        }
+        return true;
+    }
+    if (type == MSG_END) {
+        std::uint32_t match;
+        std::uint8_t winner;
+        std::uint32_t tick;
+        if (!reader.u32(match) || !reader.u8(winner) || !reader.u32(tick)) return false;
+        stats.matches++;
+        if (static_cast<std::int8_t>(winner) == client.seat) stats.wins++;
+        client.playing = false;
+        client.seat = -1;
+        if (rejoin) send_join(client, num_players);
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    const char* socket_path = nullptr;
+    int num_clients = 100;
+    int num_players = 2;
+    double rate = 10.0;
+    double duration = 10.0;
+    std::uint32_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Opção sem valor: %s\n", argv[i]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--socket") == 0) socket_path = value;
+        else if (std::strcmp(argv[i - 1], "--clients") == 0) num_clients = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--players") == 0) num_players = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--rate") == 0) rate = std::atof(value);
+        else if (std::strcmp(argv[i - 1], "--duration") == 0) duration = std::atof(value);
+        else if (std::strcmp(argv[i - 1], "--seed") == 0) seed = static_cast<std::uint32_t>(std::atol(value));
+        else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", argv[i - 1]);
+            return 1;
+        }
+    }
+    if (num_players < 1 || num_players > SERVER_MAX_PLAYERS) {
+        std::fprintf(stderr, "Jogadores por partida: 1 a %d\n", SERVER_MAX_PLAYERS);
+        return 1;
+    }
+    if (num_clients < 1) num_clients = 1;
+    if (rate <= 0) rate = 1;
+
+    const std::string path = server_socket_path(socket_path);
+    const long long interval_ns = static_cast<long long>(1e9 / rate);
+    Xoshiro128 random(seed);
+    ClientStats stats;
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<std::unique_ptr<Client>> clients;
+    const long long start_ns = now_ns();
+    for (int i = 0; i < num_clients; ++i) {
+        int fd = connect_server(path);
+        if (fd < 0) {
+            std::fprintf(stderr, "Não foi possível conectar a %s (conexão %d)\n", path.c_str(), i + 1);
+            return 1;
+        }
+        clients.push_back(std::make_unique<Client>());
+        Client& client = *clients.back();
+        client.fd = fd;
+        client.next_input_ns = start_ns + random.below(static_cast<int>(interval_ns / 1000 + 1)) * 1000LL;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u32 = static_cast<std::uint32_t>(i);
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+        send_join(client, num_players);
+    }
+
+    const long long end_ns = start_ns + static_cast<long long>(duration * 1e9);
+    std::vector<epoll_event> events(256);
+    std::vector<std::uint8_t> input;
+    std::uint8_t buffer[16384];
+    int open_clients = num_clients;
+    while (open_clients > 0) {
+        long long now = now_ns();
+        if (now >= end_ns) break;
+
+        // Comandos que venceram; o epoll dorme até o próximo
+        long long next = end_ns;
+        for (std::unique_ptr<Client>& client : clients) {
+            if (client->fd < 0) continue;
+            if (client->playing && client->next_input_ns <= now) {
+                input.clear();
+                MessageWriter writer(input);
+                writer.begin(MSG_INPUT);
+                writer.u8(static_cast<std::uint8_t>(RANDOM_COMMANDS[random.below(8)]));
+                writer.end();
+                if (send_all(client->fd, input)) {
+                    stats.inputs++;
+                    if (client->pending_ns == 0) client->pending_ns = now;
+                }
+                client->next_input_ns = now + interval_ns;
+            }
+            if (client->playing) next = std::min(next, client->next_input_ns);
+        }
+
+        int timeout = static_cast<int>((next - now + 999999) / 1000000);
+        int n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), timeout);
+        if (n < 0 && errno != EINTR) break;
+        for (int i = 0; i < n; ++i) {
+            Client& client = *clients[events[i].data.u32];
+            ssize_t got = read(client.fd, buffer, sizeof(buffer));
+            if (got < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+            bool ok = got > 0;
+            if (ok) {
+                stats.bytes += got;
+                client.parser.feed(buffer, static_cast<std::size_t>(got));
+                MessageType type;
+                const std::uint8_t* body;
+                std::size_t size;
+                while (ok && client.parser.next(type, body, size)) {
+                    ok = handle_message(client, type, body, size, stats, now_ns() < end_ns, num_players);
+                }
+            }
+            if (!ok) {
+                stats.errors++;
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, client.fd, nullptr);
+                close(client.fd);
+                client.fd = -1;
+                open_clients--;
+            }
+        }
+    }
+    const double elapsed = (now_ns() - start_ns) / 1e9;
+    for (std::unique_ptr<Client>& client : clients) {
+        if (client->fd >= 0) close(client->fd);
+    }
+    close(epoll_fd);
+
+    std::printf("%d clientes, %d jogadores por partida, %.1f s\n", num_clients, num_players, elapsed);
+    std::printf("partidas terminadas: %lld (%.1f/s), vitorias: %lld, erros: %lld\n", stats.matches,
+                stats.matches / elapsed, stats.wins, stats.errors);
+    std::printf("comandos enviados: %lld, estados recebidos: %lld (%.0f/s), %.1f bytes por estado\n", stats.inputs,
+                stats.states, stats.states / elapsed, stats.states > 0 ? double(stats.bytes) / stats.states : 0.0);
+    if (!stats.latency_ns.empty()) {
+        std::vector<long long>& lat = stats.latency_ns;
+        std::sort(lat.begin(), lat.end());
+        long long total = 0;
+        for (long long ns : lat) total += ns;
+        std::printf("latencia comando -> estado: media %.1f us, p50 %.1f us, p99 %.1f us, max %.1f us\n",
+                    total / 1000.0 / lat.size(), lat[lat.size() / 2] / 1000.0, lat[lat.size() * 99 / 100] / 1000.0,
+                    lat.back() / 1000.0);
+    }
+    return 0;
+}
@@ -4,6 +4,9 @@
 const int BOARD_WIDTH = 10;
 const int BOARD_HEIGHT = 20;
 
+// Máscara de uma linha completa no bitboard (um bit por coluna)
+const unsigned FULL_ROW_MASK = (1u << BOARD_WIDTH) - 1; // 0x3FF
+
 // Posição inicial da renderização
 const int P1_X_OFFSET = 5;
 const int P1_Y_OFFSET = 2;
@@ -15,10 +18,12 @@ const int P1_LEFT = 'a';
 const int P1_RIGHT = 'd';
 const int P1_ROTATE = 'w';
 const int P1_DOWN = 's';
+const int P1_HARD_DROP = 'e';
 
 const int P2_LEFT = 'j';
 const int P2_RIGHT = 'l';
 const int P2_ROTATE = 'i';
 const int P2_DOWN = 'k';
+const int P2_HARD_DROP = 'o';
 
 const int QUIT_GAME = 'q';
\ No newline at end of file
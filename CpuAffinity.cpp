@@ -0,0 +1,88 @@
+#include "CpuAffinity.h"
+#include <cstdlib>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/// @brief Lê uma lista de núcleos no formato do taskset ("0,2-3")
+/// @param text Lista separada por vírgulas, com intervalos a-b
+/// @param cpus Recebe os núcleos, na ordem da lista
+/// @return false se a lista está mal formada ou vazia
+bool parse_cpu_list(const char* text, std::vector<int>& cpus) {
+    cpus.clear();
+    const char* p = text;
+    while (*p) {
+        char* end = nullptr;
+        long first = std::strtol(p, &end, 10);
+        if (end == p || first < 0 || first >= CPU_SETSIZE) return false;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            ++p;
+            last = std::strtol(p, &end, 10);
+            if (end == p || last < first || last >= CPU_SETSIZE) return false;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last; ++cpu) cpus.push_back(static_cast<int>(cpu));
+        if (*p == ',') ++p;
+        else if (*p != '\0') return false;
+    }
+    return !cpus.empty();
+}
+
+/// @brief Núcleos em que o processo pode rodar (respeita taskset/cgroups)
+std::vector<int> available_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) cpus.push_back(0);
+    return cpus;
+}
+
+/// @brief Fixa uma thread num núcleo
+/// @return false se o sistema recusou (a thread continua livre)
+bool pin_thread(pthread_t thread, int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+}
+
+bool pin_current_thread(int cpu) {
+    return pin_thread(pthread_self(), cpu);
+}
+
+/// @brief Limita a thread atual (e as que ela criar depois) a um conjunto de núcleos
+bool restrict_current_thread(const std::vector<int>& cpus) {
+    if (cpus.empty()) return true;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/// @brief Ajusta a prioridade da thread atual (herdada pelas que ela criar depois).
+/// SCHED_FIFO e nice negativo exigem CAP_SYS_NICE
+/// @param rt_priority Prioridade de tempo real (0 = mantém a política normal)
+/// @param nice_value Nice da thread (0 = não mexe)
+/// @return false se algum dos ajustes foi recusado
+bool set_current_thread_priority(int rt_priority, int nice_value) {
+    bool ok = true;
+    if (rt_priority > 0) {
+        sched_param param{};
+        param.sched_priority = rt_priority;
+        ok &= pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+    }
+    if (nice_value != 0) {
+        // No Linux o nice é por thread: PRIO_PROCESS com o tid afeta só esta
+        pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        ok &= setpriority(PRIO_PROCESS, static_cast<id_t>(tid), nice_value) == 0;
+    }
+    return ok;
+}
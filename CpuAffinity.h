@@ -0,0 +1,18 @@
+#pragma once
+
+#include <pthread.h>
+#include <vector>
+
+// Afinidade de CPU e prioridade de escalonamento das threads (Linux).
+// Threads criadas depois herdam a máscara e a prioridade de quem as criou,
+// então basta ajustar a thread principal antes de criar as outras.
+
+bool parse_cpu_list(const char* text, std::vector<int>& cpus); // "0,2-3"
+std::vector<int> available_cpus();
+
+bool pin_thread(pthread_t thread, int cpu);
+bool pin_current_thread(int cpu);
+bool restrict_current_thread(const std::vector<int>& cpus);
+
+// rt_priority > 0: SCHED_FIFO com essa prioridade (1-99); nice_value != 0: ajusta o nice
+bool set_current_thread_priority(int rt_priority, int nice_value);
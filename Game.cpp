@@ -1,12 +1,118 @@
 #include "Game.h"
 #include "Constants.h"
+#include "CpuAffinity.h"
 #include <chrono>
 #include <clocale>
+#include <cstdio>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <unistd.h>
 
-using namespace std::chrono_literals;
 
-// Inicializa as pontuações e o estado do jogo
-Game::Game() : game_over(false), p1_score(0), p2_score(0) {
+/// @brief Relógio em ns, usado para carimbar o input e medir latências
+static long long now_ns() {
+    return SimClock::steady_ns();
+}
+
+/// @brief Relógio em ms, na mesma base dos prazos dos jogadores (SimClock::tick_deadline_ms)
+static long now_ms() {
+    return static_cast<long>(SimClock::steady_ns() / 1000000);
+}
+
+/// @brief Lê o nome de um modelo de execução (--threading)
+/// @return false se o nome é desconhecido
+bool parse_threading(const char* name, ThreadingModel& model) {
+    if (std::strcmp(name, "roles") == 0) model = THREADING_ROLES;
+    else if (std::strcmp(name, "reactor") == 0) model = THREADING_REACTOR;
+    else return false;
+    return true;
+}
+
+/// @brief Imprime a latência input -> aplicação de um jogador
+static void print_latency(const char* name, const InputLatency& latency) {
+    if (latency.count == 0) return;
+    std::printf("%s: %lld comandos, latencia media %.1f us, maxima %.1f us\n", name, latency.count,
+                latency.total_ns / 1000.0 / latency.count, latency.max_ns / 1000.0);
+}
+
+// Pedido de dump das métricas feito pelo handler do SIGUSR1 e atendido pela renderização,
+// que o handler acorda pelo render_fd (a renderização pode estar dormindo sem mudanças)
+static std::atomic<bool> metrics_dump_requested{false};
+static std::atomic<int> metrics_wake_fd{-1};
+static_assert(std::atomic<bool>::is_always_lock_free, "usado dentro de um handler de sinal");
+static_assert(std::atomic<int>::is_always_lock_free, "usado dentro de um handler de sinal");
+
+static void on_metrics_signal(int) {
+    metrics_dump_requested.store(true, std::memory_order_relaxed);
+    int fd = metrics_wake_fd.load(std::memory_order_relaxed);
+    if (fd >= 0) {
+        std::uint64_t one = 1;
+        ssize_t written = write(fd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+/// @brief Atende um pedido de dump feito pelo SIGUSR1, se houver
+static void serve_metrics_dump(const char* path) {
+    if (metrics_dump_requested.exchange(false, std::memory_order_relaxed)) dump_metrics(path);
+}
+
+/// @brief Esvazia um eventfd (o contador volta a zero)
+static void drain_eventfd(int fd) {
+    std::uint64_t count;
+    ssize_t got = read(fd, &count, sizeof(count));
+    (void)got; // EAGAIN: já estava vazio
+}
+
+/// @brief Publica o estado atual de um jogador para a renderização
+/// @param slot Jogador (só o worker que o processa chama esta função)
+static void publish_snapshot(PlayerSlot& slot) {
+    fill_snapshot(slot.snapshots.write_buffer(), slot.player, ++slot.snapshot_version);
+    slot.snapshots.publish();
+    slot.alive = !slot.player.is_game_over();
+    slot.score = slot.player.get_score();
+}
+
+// Inicializa o estado do jogo
+Game::Game(const GameOptions& options)
+    : options(options),
+      game_over(false),
+      clock(options.time_scale),
+      bot_delay_ticks(ms_to_ticks(options.bot_delay_ms)),
+      wake_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      render_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      garbage_router(options.targeting, static_cast<std::uint32_t>(now_ns())),
+      scheduler(options.num_players < 2 ? 2 : options.num_players, [this](int index) { return player_step(index); }) {
+    if (this->options.num_players < 2) this->options.num_players = 2;
+    const bool reactor = options.threading == THREADING_REACTOR;
+
+    // Afinidade e prioridade valem para todas as threads criadas daqui em diante (inclusive o pool do bot)
+    if (!restrict_current_thread(options.cpus)) {
+        std::fprintf(stderr, "Não foi possível restringir as threads aos núcleos pedidos\n");
+    }
+    if (!set_current_thread_priority(options.rt_priority, options.nice_value)) {
+        std::fprintf(stderr, "Não foi possível ajustar a prioridade (requer CAP_SYS_NICE)\n");
+    }
+
+    bool any_bot = false;
+    for (int i = 0; i < this->options.num_players; ++i) {
+        slots.push_back(std::make_unique<PlayerSlot>());
+        slots[i]->player = Player(options.speed_curve);
+        slots[i]->is_bot = (i >= 2) || options.bot[i];
+        any_bot |= slots[i]->is_bot;
+    }
+    if (reactor) reactor_deadlines.assign(slots.size(), 0); // Todos os jogadores começam prontos
+    if (any_bot && reactor) {
+        bot = std::make_unique<Bot>(options.bot_depth); // Busca serial, na thread do reator
+    } else if (any_bot) {
+        bot_pool = std::make_unique<ThreadPool>();
+        bot = std::make_unique<Bot>(*bot_pool, options.bot_depth);
+    }
     init_curses();
 }
 
@@ -14,15 +120,88 @@ Game::Game() : game_over(false), p1_score(0), p2_score(0) {
 Game::~Game() {
     // Espera todas as threads terminarem.
     // A flag game_over (atômica) garante que elas vão parar
+    request_stop();
     if (t_input.joinable()) t_input.join();
     if (t_render.joinable()) t_render.join();
-    if (t_player1.joinable()) t_player1.join();
-    if (t_player2.joinable()) t_player2.join();
+    scheduler.stop();
 
     cleanup_curses(); // Limpa o ncurses depois que as threads pararem
+    if (wake_fd >= 0) close(wake_fd);
+    if (render_fd >= 0) close(render_fd);
+
+    if (recorder) {
+        long end = clock.now();
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            recorder->record_end(static_cast<int>(i), slots[i]->player, end);
+        }
+        recorder->close();
+        if (recorder->get_dropped_events() > 0) {
+            std::printf("Replay incompleto: %ld registros perdidos\n", recorder->get_dropped_events());
+        }
+    }
+
+    // Os espectadores veem a partida terminar e continuam com o último quadro
+    if (spectators) {
+        if (!spectators->is_open()) {
+            std::printf("Não foi possível criar o segmento de espectadores %s\n", options.spectate_name);
+        }
+        spectators->close();
+    }
+
+    print_latency("Jogador 1", slots[0]->latency);
+    print_latency("Jogador 2", slots[1]->latency);
+
+    // Para comparar os modelos de execução: cada thread que dorme e acorda custa trocas de contexto
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        std::printf("Modelo %s: %ld trocas de contexto voluntarias, %ld involuntarias\n",
+                    options.threading == THREADING_REACTOR ? "reactor" : "roles", usage.ru_nvcsw, usage.ru_nivcsw);
+    }
+
+    if (options.metrics_path) {
+        std::signal(SIGUSR1, SIG_DFL);
+        metrics_wake_fd.store(-1, std::memory_order_relaxed);
+        if (!dump_metrics(options.metrics_path)) {
+            std::printf("Não foi possível gravar as métricas em %s\n", options.metrics_path);
+        }
+    }
+}
+
+/// @brief Termina o jogo e acorda todos os jogadores (e a thread de input) para que vejam a flag
+void Game::request_stop() {
+    game_over = true;
+    if (wake_fd >= 0) {
+        std::uint64_t one = 1;
+        ssize_t written = write(wake_fd, &one, sizeof(one));
+        (void)written; // Só falha se o contador já estiver cheio, e aí o despertar já está pendente
+    }
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        wake_player(static_cast<int>(i));
+    }
+}
+
+/// @brief Avisa a renderização de que algum snapshot mudou (chamado depois de cada publicação).
+/// Só a primeira mudança depois do último quadro escreve no render_fd: uma rajada
+/// de publicações vira um único despertar e um único quadro
+void Game::request_frame() {
+    if (frame_epoch.fetch_add(1) != drawn_epoch.load()) return; // A renderização já foi avisada
+    // No modelo reator a renderização é a própria thread que publicou
+    if (options.threading == THREADING_ROLES && render_fd >= 0) {
+        std::uint64_t one = 1;
+        ssize_t written = write(render_fd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+/// @brief Processa um jogador assim que possível (input, lixo recebido, fim de jogo)
+void Game::wake_player(int index) {
+    if (options.threading == THREADING_REACTOR) {
+        if (reactor_deadlines[index] >= 0) reactor_deadlines[index] = 0;
+    } else {
+        scheduler.notify(index);
+    }
 }
 
-/// @brief Configura o ncurses para exibir o jogo no terminal
 void Game::init_curses() {
     setlocale(LC_ALL, ""); // Permite o ncurses usar caracteres especiais
     initscr(); // Prepara o terminal
@@ -32,15 +211,7 @@ void Game::init_curses() {
     keypad(stdscr, TRUE); // Habilita o keypad na janela principal para ler caracteres especiais
     nodelay(stdscr, TRUE); // Não espera I/O para continuar execução
     
-    start_color(); // Habilita o uso de cores e cria um par de cor para cada peça do tetris
-    init_pair(1, COLOR_CYAN, COLOR_BLACK);
-    init_pair(2, COLOR_YELLOW, COLOR_BLACK);
-    init_pair(3, COLOR_MAGENTA, COLOR_BLACK);
-    init_pair(4, COLOR_GREEN, COLOR_BLACK);
-    init_pair(5, COLOR_RED, COLOR_BLACK);
-    init_pair(6, COLOR_BLUE, COLOR_BLACK);
-    init_pair(7, COLOR_WHITE, COLOR_BLACK); 
-    init_pair(8, COLOR_WHITE, COLOR_WHITE); 
+    init_piece_colors(); // Um par de cor para cada peça do tetris
 
     // Cria janelas para os dois jogadores e suas pontuações
     p1_win = newwin(BOARD_HEIGHT + 2, BOARD_WIDTH * 2 + 2, P1_Y_OFFSET, P1_X_OFFSET);
@@ -48,6 +219,7 @@ void Game::init_curses() {
     score_win = newwin(5, 50, P1_Y_OFFSET + BOARD_HEIGHT + 3, P1_X_OFFSET);
 }
 
+
 /// @brief Deleta as janelas do ncurses
 void Game::cleanup_curses() {
     delwin(p1_win);
@@ -56,234 +228,428 @@ void Game::cleanup_curses() {
     endwin(); 
 }
 
-/// @brief Inicia as std::thread
+/// @brief Inicia as std::thread e o pool dos jogadores
 void Game::run() {
+    clock.start();
+    std::uint32_t seed = options.seed != 0 ? options.seed : static_cast<std::uint32_t>(now_ns());
+    std::vector<std::uint32_t> seeds;
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        seeds.push_back(options.shared_seed ? seed : player_seed(seed, static_cast<int>(i)));
+        slots[i]->player.reset(0, seeds[i]);
+        slots[i]->next_bot_move = bot_delay_ticks;
+        publish_snapshot(*slots[i]);
+    }
+    request_frame(); // Primeiro quadro
+
+    if (options.record_path) {
+        recorder = std::make_unique<ReplayRecorder>(options.record_path, seeds, options.speed_curve, 0);
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            slots[i]->player.attach_recorder(recorder->is_open() ? recorder.get() : nullptr, static_cast<int>(i));
+        }
+    }
+
+    if (options.spectate_name) {
+        spectators = std::make_unique<SpectatorWriter>(options.spectate_name);
+    }
+
+    if (options.metrics_path) {
+        metrics_wake_fd.store(render_fd, std::memory_order_relaxed);
+        std::signal(SIGUSR1, on_metrics_signal);
+    }
+
+    const std::vector<int>& cpus = options.cpus;
+    if (options.threading == THREADING_REACTOR) {
+        if (!cpus.empty()) pin_current_thread(cpus[0]);
+        reactor_loop();
+        return;
+    }
+
+    // Com núcleos definidos: input no primeiro, renderização no segundo, workers nos seguintes (em rodízio)
     t_input = std::thread(&Game::input_loop, this);
     t_render = std::thread(&Game::render_loop, this);
-    t_player1 = std::thread(&Game::player_loop, this, 1);
-    t_player2 = std::thread(&Game::player_loop, this, 2);
+    std::vector<int> worker_cpus;
+    if (!cpus.empty()) {
+        pin_thread(t_input.native_handle(), cpus[0]);
+        pin_thread(t_render.native_handle(), cpus[1 % cpus.size()]);
+        for (std::size_t i = 0; i < cpus.size(); ++i) worker_cpus.push_back(cpus[(2 + i) % cpus.size()]);
+    }
+    scheduler.start(options.workers, worker_cpus);
 
     // thread principal aguarda a thread de input terminar(fim do jogo)
     t_input.join(); 
-    // Quando t_input terminar (usuário apertou 'q'), as threads de jogador e renderização também terminarão
+    // Quando t_input terminar (usuário apertou 'q'), os jogadores e a renderização também terminarão
 }
 
 /// @brief THREAD 1: INPUT
 void Game::input_loop() {
+    // Bloqueia até chegar tecla ou o pedido de parada (wake_fd): sem polling
+    pollfd fds[2] = {{STDIN_FILENO, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+    bool stdin_open = true;
+
     while (!game_over) {
-        int ch = getch();
-        if (ch == ERR) {
-            std::this_thread::sleep_for(10ms); 
-            continue;
+        if (poll(stdin_open ? fds : fds + 1, stdin_open ? 2 : 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
         }
+        if (game_over || !stdin_open || (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) == 0) continue;
+        if (!handle_input(stdin_open)) return;
+    }
+}
+
+/// @brief Lê as teclas pendentes e as entrega às filas dos jogadores
+/// @param stdin_open Vira false no EOF (só resta esperar o fim do jogo)
+/// @return false se o usuário pediu para sair
+bool Game::handle_input(bool& stdin_open) {
+    PlayerSlot& p1 = *slots[0];
+    PlayerSlot& p2 = *slots[1];
+
+    // Lê tudo que está pendente de uma vez
+    unsigned char keys[256];
+    ssize_t n = read(STDIN_FILENO, keys, sizeof(keys));
+    if (n <= 0) {
+        if (n == 0 || (errno != EINTR && errno != EAGAIN)) stdin_open = false;
+        return true;
+    }
+    long long read_ns = now_ns();
+
+    bool wake_p1 = false;
+    bool wake_p2 = false;
+    for (ssize_t i = 0; i < n; ++i) {
+        int ch = keys[i];
 
         // Checa se a tecla de sair do jogo foi pressionada
         if (ch == QUIT_GAME) {
-            game_over = true;
-            break;
+            request_stop();
+            return false;
         }
-        
+
         // Checa os controles dos jogadores
-        if (ch == P1_LEFT || ch == P1_RIGHT || ch == P1_ROTATE || ch == P1_DOWN) {
-            p1_input_sem.acquire(); // Trava
-            p1_input_queue.push(ch);
-            p1_input_sem.release(); // Destrava
-        }
-        
-        if (ch == P2_LEFT || ch == P2_RIGHT || ch == P2_ROTATE || ch == P2_DOWN) {
-            p2_input_sem.acquire(); // Trava
-            p2_input_queue.push(ch);
-            p2_input_sem.release(); // Destrava
-        }
+        Command p1_cmd = (ch == P1_LEFT) ? CMD_LEFT : (ch == P1_RIGHT) ? CMD_RIGHT :
+                         (ch == P1_ROTATE) ? CMD_ROTATE : (ch == P1_DOWN) ? CMD_DOWN :
+                         (ch == P1_HARD_DROP) ? CMD_HARD_DROP : CMD_NONE;
+        Command p2_cmd = (ch == P2_LEFT) ? CMD_LEFT : (ch == P2_RIGHT) ? CMD_RIGHT :
+                         (ch == P2_ROTATE) ? CMD_ROTATE : (ch == P2_DOWN) ? CMD_DOWN :
+                         (ch == P2_HARD_DROP) ? CMD_HARD_DROP : CMD_NONE;
+
+        // Fila cheia: a tecla é descartada (a leitura do input nunca bloqueia)
+        if (p1_cmd != CMD_NONE && !p1.is_bot) wake_p1 |= p1.input_ring.try_push({p1_cmd, read_ns});
+        if (p2_cmd != CMD_NONE && !p2.is_bot) wake_p2 |= p2.input_ring.try_push({p2_cmd, read_ns});
     }
+
+    // Um único notify por jogador para o lote inteiro
+    if (wake_p1) wake_player(0);
+    if (wake_p2) wake_player(1);
+    return true;
+}
+
+/// @brief Publica um quadro para os espectadores com os snapshots lidos pela renderização
+/// @param writer Segmento compartilhado
+/// @param boards Snapshot de cada jogador, lido neste quadro
+/// @param tick Tick atual da simulação
+/// @param alive Jogadores vivos
+/// @param winner Último jogador vivo (considerado só quando alive == 1)
+static void publish_spectator_frame(SpectatorWriter& writer, const std::vector<const BoardSnapshot*>& boards,
+                                    long tick, int alive, int winner) {
+    const int num_players = static_cast<int>(boards.size());
+    SpectatorFrame& frame = writer.begin_frame();
+    frame.tick = tick;
+    frame.num_players = num_players;
+    frame.num_boards = num_players < SPECTATOR_MAX_BOARDS ? num_players : SPECTATOR_MAX_BOARDS;
+    frame.alive = alive;
+    frame.winner = (alive == 1) ? winner : -1;
+    for (int i = 0; i < frame.num_boards; ++i) frame.boards[i] = *boards[i];
+    writer.commit_frame();
+}
+
+/// @brief Prepara o estado da renderização antes do primeiro quadro
+void Game::init_render_state(RenderState& render) {
+    const int num_players = static_cast<int>(slots.size());
+    std::memset(render.last_next, -1, sizeof(render.last_next));
+    render.boards.assign(num_players, nullptr);
+    render.spectator_versions.assign(num_players, 0);
+    render.spectator_writer = (spectators && spectators->is_open()) ? spectators.get() : nullptr;
+}
+
+/// @brief Intervalo mínimo entre dois quadros (--max-fps; 0 = sem limite)
+long Game::frame_interval_ms() const {
+    return options.max_fps > 0 ? (1000 + options.max_fps - 1) / options.max_fps : 0;
 }
 
 /// @brief THREAD 2: RENDER
-// Atualiza a tela com o estado atual do jogo
+// Atualiza a tela quando o estado do jogo muda: dorme sem prazo enquanto nada
+// muda e desenha no máximo --max-fps quadros por segundo, juntando num só
+// quadro todas as publicações que chegarem nesse intervalo
 void Game::render_loop() {
+    RenderState render;
+    init_render_state(render);
+    pollfd fds[2] = {{render_fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+    long next_frame = 0;
+
     while (!game_over) {
-        p1_board_sem.acquire(); // LOCK P1
-        p2_board_sem.acquire(); // LOCK P2
-        
-        p1_board.draw(p1_win);
-        p2_board.draw(p2_win);
-        
-        p2_board_sem.release(); // UNLOCK P2
-        p1_board_sem.release(); // UNLOCK P1
+        if (frame_epoch.load() == drawn_epoch.load()) {
+            // Nada novo desde o último quadro: dorme até um request_frame(), o SIGUSR1 ou o fim do jogo
+            if (poll(fds, 2, -1) < 0 && errno != EINTR) break;
+            drain_eventfd(render_fd);
+            serve_metrics_dump(options.metrics_path);
+            continue;
+        }
 
+        // Limite de FPS: o que for publicado durante a espera entra neste mesmo quadro
+        long now = now_ms();
+        if (now < next_frame) std::this_thread::sleep_for(std::chrono::milliseconds(next_frame - now));
+        if (game_over) break;
+
+        // Marca as mudanças como vistas antes de ler os snapshots: uma publicação
+        // depois daqui incrementa frame_epoch de novo e gera outro quadro
+        drawn_epoch.store(frame_epoch.load());
+        render_frame(render);
+        next_frame = now_ms() + frame_interval_ms();
+    }
+}
+
+/// @brief Desenha um quadro; se a partida acabou, mostra o resultado e espera o 'q'
+void Game::render_frame(RenderState& render) {
+    METRIC_TIMER_START(frame_start);
+    serve_metrics_dump(options.metrics_path);
+    const int num_players = static_cast<int>(slots.size());
+    std::vector<const BoardSnapshot*>& boards = render.boards;
+
+    // Lê os snapshots mais recentes, uma vez por quadro (cada read() pode trocar o buffer):
+    // nenhum tabuleiro é travado durante o I/O do terminal
+    for (int i = 0; i < num_players; ++i) boards[i] = &slots[i]->snapshots.read();
+    const BoardSnapshot& p1 = *boards[0];
+    const BoardSnapshot& p2 = *boards[1];
+
+    // Só as células que mudaram são enviadas; um único doupdate() por quadro
+    bool dirty = render.p1_renderer.draw(p1_win, p1);
+    dirty |= render.p2_renderer.draw(p2_win, p2);
+
+    // Checa o estado dos tabuleiros (os jogadores além do 2 só aparecem na contagem)
+    int alive = 0;
+    int winner = -1;
+    for (int i = 0; i < num_players; ++i) {
+        if (!boards[i]->game_over) {
+            alive++;
+            winner = i;
+        }
+    }
+
+    // Espectadores recebem um quadro sempre que algum jogador publicou algo novo
+    if (render.spectator_writer) {
+        bool changed = false;
+        for (int i = 0; i < num_players; ++i) {
+            changed |= boards[i]->version != render.spectator_versions[i];
+            render.spectator_versions[i] = boards[i]->version;
+        }
+        if (changed) publish_spectator_frame(*render.spectator_writer, boards, clock.now(), alive, winner);
+    }
+
+    if (p1.score != render.last_p1_score || p2.score != render.last_p2_score || alive != render.last_alive ||
+        std::memcmp(p1.next_pieces, render.last_next[0], PREVIEW_SIZE) != 0 ||
+        std::memcmp(p2.next_pieces, render.last_next[1], PREVIEW_SIZE) != 0) {
+        render.last_p1_score = p1.score;
+        render.last_p2_score = p2.score;
+        render.last_alive = alive;
+        std::memcpy(render.last_next[0], p1.next_pieces, PREVIEW_SIZE);
+        std::memcpy(render.last_next[1], p2.next_pieces, PREVIEW_SIZE);
         werase(score_win);
         box(score_win, 0, 0);
-        mvwprintw(score_win, 1, 2, "Jogador 1: %d", p1_score);
-        mvwprintw(score_win, 2, 2, "Jogador 2: %d", p2_score);
+        mvwprintw(score_win, 1, 2, "Jogador 1: %d Nv%d", p1.score, p1.level);
+        mvwprintw(score_win, 2, 2, "Jogador 2: %d Nv%d", p2.score, p2.level);
+        print_preview(score_win, 1, 25, p1);
+        print_preview(score_win, 2, 25, p2);
         mvwprintw(score_win, 3, 2, "Pressione 'q' para sair");
-        wrefresh(score_win);
+        if (num_players > 2) mvwprintw(score_win, 3, 30, "Vivos: %d/%d", alive, num_players);
+        wnoutrefresh(score_win);
+        dirty = true;
+    }
 
-        // Checa o estado dos tabuleiros
-        bool p1_lost, p2_lost;
-
-        p1_board_sem.acquire();
-        p1_lost = p1_board.is_game_over();
-        p1_board_sem.release();
-
-        p2_board_sem.acquire();
-        p2_lost = p2_board.is_game_over();
-        p2_board_sem.release();
-
-        if (p1_lost || p2_lost) {
-            game_over = true; 
-            
-            // Atualiza a tela uma última vez com o estado final
-            p1_board_sem.acquire();
-            p2_board_sem.acquire();
-            p1_board.draw(p1_win);
-            p2_board.draw(p2_win);
-            p2_board_sem.release();
-            p1_board_sem.release();
-
-            // Exibe o vencedor
-            mvwprintw(score_win, 1, 25, "FIM DE JOGO!");
-            if (p1_lost && !p2_lost) {
-                mvwprintw(score_win, 2, 25, "Jogador 2 Venceu!");
-            } else if (p2_lost && !p1_lost) {
-                mvwprintw(score_win, 2, 25, "Jogador 1 Venceu!");
-            } else {
-                mvwprintw(score_win, 2, 25, "Empate!"); // Caso raro
-            }
-            
-            // Muda o ncurses para o modo de input "bloqueante"
-            nodelay(stdscr, FALSE);
-            
-            // Sobrescreve a mensagem de ajuda
-            mvwprintw(score_win, 3, 2, "Pressione 'q' para sair... "); 
-            wrefresh(score_win);
-            
-            // Fica preso aqui até o usuário pressionar 'q'
-            while (getch() != 'q') {
-                // Espera
-            }
+    if (dirty) doupdate();
+    METRIC_TIMER_STOP(METRIC_FRAME_TIME, frame_start);
+
+    if (alive <= 1) {
+        request_stop();
+
+        // Atualiza a tela uma última vez com o estado final
+        render.p1_renderer.draw(p1_win, slots[0]->snapshots.read());
+        render.p2_renderer.draw(p2_win, slots[1]->snapshots.read());
+        doupdate();
+
+        // Exibe o vencedor
+        mvwprintw(score_win, 1, 25, "FIM DE JOGO!");
+        if (alive == 1) {
+            mvwprintw(score_win, 2, 25, "Jogador %d Venceu!", winner + 1);
+        } else {
+            mvwprintw(score_win, 2, 25, "Empate!"); // Caso raro
         }
 
-        std::this_thread::sleep_for(33ms); // ~30 FPS
+        // Muda o ncurses para o modo de input "bloqueante"
+        nodelay(stdscr, FALSE);
+
+        // Sobrescreve a mensagem de ajuda
+        mvwprintw(score_win, 3, 2, "Pressione 'q' para sair... ");
+        wrefresh(score_win);
+
+        // Fica preso aqui até o usuário pressionar 'q'
+        while (getch() != 'q') {
+            // Espera
+        }
     }
 }
 
-/// @brief THREAD 3 & 4: PLAYER LOGIC
-/// @param player_id Referência a qual player a thread está lidando
-void Game::player_loop(int player_id) {
-    // Referências para o jogador atual e oponente
-    Board& my_board = (player_id == 1) ? p1_board : p2_board;
-    int& my_score = (player_id == 1) ? p1_score : p2_score;
-    std::binary_semaphore& my_board_sem = (player_id == 1) ? p1_board_sem : p2_board_sem;
-    std::binary_semaphore& my_input_sem = (player_id == 1) ? p1_input_sem : p2_input_sem;
-    std::queue<int>& my_input_queue = (player_id == 1) ? p1_input_queue : p2_input_queue;
-    
-    // Referências para o sistema de lixo
-    std::counting_semaphore<100>& my_garbage_sem = (player_id == 1) ? p1_garbage_sem : p2_garbage_sem;
-    std::counting_semaphore<100>& opp_garbage_sem = (player_id == 1) ? p2_garbage_sem : p1_garbage_sem;
-    
-    const int p_left = (player_id == 1) ? P1_LEFT : P2_LEFT;
-    const int p_right = (player_id == 1) ? P1_RIGHT : P2_RIGHT;
-    const int p_rotate = (player_id == 1) ? P1_ROTATE : P2_ROTATE;
-    const int p_down = (player_id == 1) ? P1_DOWN : P2_DOWN;
+/// @brief MODELO REATOR: input, jogadores e renderização na thread principal.
+/// Dorme num único poll() até a próxima tecla, o próximo prazo de um jogador
+/// ou o próximo quadro (só quando algo mudou, respeitando o --max-fps); como
+/// nada roda em paralelo, não há travas nem notify
+void Game::reactor_loop() {
+    RenderState render;
+    init_render_state(render);
 
-    auto last_drop_time = std::chrono::steady_clock::now();
-    long drop_speed = 1000; // 1 segundo
+    // render_fd só recebe o despertar do SIGUSR1 neste modelo
+    pollfd fds[3] = {{STDIN_FILENO, POLLIN, 0}, {wake_fd, POLLIN, 0}, {render_fd, POLLIN, 0}};
+    bool stdin_open = true;
+    long next_frame = 0;
 
     while (!game_over) {
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_drop_time);
+        // Jogadores cujo prazo venceu (ou que receberam input/lixo: prazo 0)
+        long now = now_ms();
+        for (std::size_t i = 0; i < slots.size() && !game_over; ++i) {
+            long& deadline = reactor_deadlines[i];
+            if (deadline >= 0 && deadline <= now) deadline = player_step(static_cast<int>(i));
+        }
 
-        // 1. Processar Lixo recebido
-        int garbage_to_add = 0;
-        while (my_garbage_sem.try_acquire()) {
-            garbage_to_add++;
+        now = now_ms();
+        bool dirty = frame_epoch.load() != drawn_epoch.load();
+        if (dirty && now >= next_frame) {
+            drawn_epoch.store(frame_epoch.load());
+            render_frame(render);
+            next_frame = now + frame_interval_ms();
+            dirty = false;
         }
+        if (game_over) break;
 
-        if (garbage_to_add > 0) {
-            my_board_sem.acquire();
-            my_board.add_garbage(garbage_to_add);
-            bool died = my_board.is_game_over();
-            my_board_sem.release();
-            
-            if (died) {
-                game_over = true;
-                break;
-            }
+        // Dorme até o evento mais próximo (sem mudanças na tela e sem jogadores ativos, sem prazo)
+        long wake = dirty ? next_frame : LONG_MAX;
+        for (long deadline : reactor_deadlines) {
+            if (deadline >= 0 && deadline < wake) wake = deadline;
+        }
+        int timeout = wake == LONG_MAX ? -1 : wake > now ? static_cast<int>(wake - now) : 0;
+        if (poll(stdin_open ? fds : fds + 1, stdin_open ? 3 : 2, timeout) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[2].revents & POLLIN) {
+            drain_eventfd(render_fd);
+            serve_metrics_dump(options.metrics_path);
         }
+        if (stdin_open && (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) != 0 && !handle_input(stdin_open)) break;
+    }
+}
 
-        // 2. Processar Input do Jogador
-        my_input_sem.acquire(); 
-        bool has_input = !my_input_queue.empty();
-        my_input_sem.release();
-
-        if (has_input) { 
-            my_board_sem.acquire();
-            my_input_sem.acquire();
-            while (!my_input_queue.empty()) {
-                int cmd = my_input_queue.front();
-                my_input_queue.pop();
-                my_input_sem.release(); // Libera input para a thread de leitura não engasgar
-
-                // Lógica de Movimento (Board já está travado)
-                if (cmd == p_left) my_board.move_piece(-1, 0);
-                else if (cmd == p_right) my_board.move_piece(1, 0);
-                else if (cmd == p_rotate) my_board.rotate_piece();
-                else if (cmd == p_down) {
-                    if (my_board.move_piece(0, 1)) {
-                        last_drop_time = std::chrono::steady_clock::now();
-                    } else {
-                        // Fixar peça
-                        int lines_cleared = my_board.fix_piece_and_clear_lines();
-                        my_board.spawn_new_piece();
-                        if (my_board.is_game_over()) {
-                             my_board_sem.release(); 
-                             goto end_loop;
-                        }
-                    
-                        my_score += lines_cleared * lines_cleared * 10;
-                        int garbage_to_send = (lines_cleared >= 4) ? 3 : (lines_cleared >= 2 ? lines_cleared - 1 : 0);
-                        if (garbage_to_send > 0) opp_garbage_sem.release(garbage_to_send);
-                        
-                        last_drop_time = std::chrono::steady_clock::now();
-                    }
-                }
-                my_input_sem.acquire();
-            }
-            my_input_sem.release(); // Solta input final
-            my_board_sem.release(); // Solta board final
+/// @brief Cancela o lixo pendente de quem atacou e entrega o resto aos alvos
+/// escolhidos pelo roteador, acordando-os
+/// @param from Índice de quem limpou as linhas (só o worker dele chama)
+/// @param result Resultado da fixação, com o tamanho e o buraco do ataque
+void Game::send_garbage(int from, const StepResult& result) {
+    if (result.garbage_to_send <= 0) return;
+    int lines = slots[from]->garbage.cancel(result.garbage_to_send);
+    if (lines <= 0) return;
+
+    std::vector<PlayerStatus> status(slots.size());
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        status[i].alive = slots[i]->alive;
+        status[i].score = slots[i]->score;
+    }
+    std::vector<int> targets;
+    garbage_router.pick_targets(from, status, targets);
+    for (int target : targets) {
+        slots[target]->garbage.push({lines, result.garbage_hole});
+        wake_player(target);
+    }
+}
+
+/// @brief PLAYER LOGIC: um passo de um jogador, executado por um worker do scheduler.
+/// Tudo acontece em ticks do SimClock: comandos no tick em que a tecla foi lida,
+/// quedas da gravidade no tick em que venceram (mesmo que o worker acorde atrasado)
+/// e jogadas do bot no tick agendado, sempre em ordem de tick.
+/// @param index Índice do jogador que está sendo processado
+/// @return Próximo prazo do jogador (ms do steady_clock), ou -1 se ele não precisa mais ser processado
+long Game::player_step(int index) {
+    PlayerSlot& slot = *slots[index];
+    Player& me = slot.player;
+    if (game_over || me.is_game_over()) return -1;
+
+    const long now = clock.now();
+    bool changed = false;
+
+    // 1. Comandos pendentes do teclado (a fila entrega em ordem de leitura)
+    slot.inputs.clear();
+    slot.input_ring.drain([&](const InputEvent& ev) { slot.inputs.push_back(ev); });
+    std::size_t next_input = 0;
+
+    // 2. Comandos, jogadas do bot e gravidade até o tick atual, em ordem de tick
+    //    (no mesmo tick, o comando vem antes da queda)
+    while (!me.is_game_over()) {
+        long event_tick = LONG_MAX;
+        if (next_input < slot.inputs.size()) {
+            event_tick = clock.tick_at(slot.inputs[next_input].read_ns);
+            // Tecla lida depois de `now` ser medido: aplicada agora, senão sairia da fila sem ser aplicada
+            if (event_tick > now) event_tick = now;
+        } else if (slot.is_bot) {
+            event_tick = slot.next_bot_move;
         }
+        if (event_tick < slot.sim_tick) event_tick = slot.sim_tick; // Tecla lida depois de um passo já ter passado dela
+        long gravity_tick = me.next_drop_tick();
+
+        StepResult result;
+        if (event_tick <= now && event_tick <= gravity_tick) {
+            slot.sim_tick = event_tick;
+            if (next_input < slot.inputs.size()) {
+                const InputEvent& ev = slot.inputs[next_input++];
+                result = me.apply_command(ev.cmd, event_tick);
 
-        // 3. Processar Gravidade (Tick do Jogo)
-        if (elapsed.count() > drop_speed) {
-            last_drop_time = now;
-            bool piece_fixed = false;
-            int lines_cleared = 0;
-
-            my_board_sem.acquire();
-            if (my_board.check_collision_on_drop()) {
-                lines_cleared = my_board.fix_piece_and_clear_lines();
-                my_board.spawn_new_piece();
-                bool died = my_board.is_game_over();
-                if (died) {
-                    game_over = true;
-                    my_board_sem.release();
-                    break;
-                }
-                piece_fixed = true;
+#if TETRIS_METRICS
+                long long latency_ns = now_ns() - ev.read_ns;
+                slot.latency.add(latency_ns);
+                METRIC_RECORD(METRIC_INPUT_LATENCY, latency_ns);
+#endif
             } else {
-                my_board.move_piece(0, 1);
+                // A busca roda no pool do bot; só este worker altera o jogador
+                Placement placement = bot->choose(me.get_board());
+                result = Bot::execute(me, placement, event_tick);
+                slot.next_bot_move = event_tick + bot_delay_ticks;
             }
-            my_board_sem.release();
+        } else if (gravity_tick <= now) {
+            slot.sim_tick = gravity_tick;
+            METRIC_RECORD(METRIC_GRAVITY_JITTER, now_ns() - clock.tick_ns(gravity_tick));
+            result = me.update_gravity(gravity_tick);
+        } else {
+            break;
+        }
+        changed = true;
+        if (!me.is_game_over()) send_garbage(index, result);
+    }
+    slot.sim_tick = now;
 
-            // 4. Enviar Lixo
-            if (piece_fixed) {
-                my_score += lines_cleared * lines_cleared * 10;
-                int garbage_to_send = (lines_cleared >= 4) ? 3 : (lines_cleared >= 2 ? lines_cleared - 1 : 0);
-                if (garbage_to_send > 0) opp_garbage_sem.release(garbage_to_send);
-            }
+    // 3. Lixo recebido: todos os ataques pendentes entram num único lote, no tick atual
+    if (!me.is_game_over()) {
+        GarbagePacket incoming[GarbageLedger::CAPACITY];
+        int incoming_count = slot.garbage.take(incoming, GarbageLedger::CAPACITY);
+        if (incoming_count > 0) {
+            me.receive_garbage(incoming, incoming_count, now);
+            changed = true;
         }
-        std::this_thread::sleep_for(50ms); // Poll rate
+    }
 
-        end_loop:;
+    // A renderização vê o game_over no snapshot e encerra o jogo
+    if (changed) {
+        publish_snapshot(slot);
+        request_frame();
     }
+    if (me.is_game_over()) return -1;
+
+    // 4. Próximo evento: queda da gravidade ou jogada do bot (input e lixo acordam antes pelo notify)
+    long deadline = me.next_drop_tick();
+    if (slot.is_bot && slot.next_bot_move < deadline) deadline = slot.next_bot_move;
+    return clock.tick_deadline_ms(deadline);
 }
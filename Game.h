@@ -1,15 +1,119 @@
 #pragma once
 
-#include "Board.h"
+#include "Bot.h"
+#include "GarbageLedger.h"
+#include "GarbageRouter.h"
+#include "Metrics.h"
+#include "Player.h"
+#include "PlayerScheduler.h"
+#include "Renderer.h"
+#include "Replay.h"
+#include "Snapshot.h"
+#include "SpectatorRing.h"
+#include "SpscRing.h"
+#include "TripleBuffer.h"
 #include <thread>
-#include <semaphore>
 #include <atomic>
-#include <queue>
+#include <memory>
+#include <vector>
 #include <ncurses.h>
 
+// Comando lido pelo input_loop, com o instante da leitura
+struct InputEvent {
+    Command cmd;
+    long long read_ns; // steady_clock, em ns
+};
+
+// Latência entre a leitura da tecla (input_loop) e sua aplicação (player_step).
+// Só o worker que processa o jogador escreve; é lida depois do stop().
+// Sem TETRIS_METRICS não é medida (fica zerada e não é impressa).
+struct InputLatency {
+    long long count = 0;
+    long long total_ns = 0;
+    long long max_ns = 0;
+
+    void add(long long ns) {
+        count++;
+        total_ns += ns;
+        if (ns > max_ns) max_ns = ns;
+    }
+};
+
+// Como o jogo distribui o trabalho entre threads
+enum ThreadingModel {
+    THREADING_ROLES,   // Uma thread de input, uma de renderização e o pool dos jogadores
+    THREADING_REACTOR, // Tudo numa única thread, multiplexado por um poll(), sem travas
+};
+
+bool parse_threading(const char* name, ThreadingModel& model);
+
+// Opções do jogo no terminal (lidas da linha de comando em main)
+struct GameOptions {
+    int num_players = 2;          // Jogadores 3..N são sempre bots e não aparecem na tela
+    unsigned workers = 0;         // Threads que processam os jogadores (0 = uma por núcleo)
+    GarbageTargeting targeting = TARGET_NEXT;
+    bool bot[2] = {false, false}; // Jogador 1/2 controlado pelo bot em vez do teclado
+    int bot_depth = 2;            // Peças consideradas pela busca do bot
+    int bot_delay_ms = 250;       // Intervalo entre as peças colocadas pelo bot
+    std::uint32_t seed = 0;       // Seed da partida (0 = usa o relógio)
+    bool shared_seed = false;     // Mesma sequência de peças para todos
+    const char* record_path = nullptr; // Grava a partida em replay, se definido
+    const char* metrics_path = nullptr; // Histogramas gravados na saída e a cada SIGUSR1
+    const char* spectate_name = nullptr; // Transmite os quadros para o tetris_view, se definido
+    double time_scale = 1.0;      // > 1 comprime o tempo da simulação (útil em partidas só de bots)
+    SpeedCurve speed_curve;       // Nível inicial e linhas por nível da gravidade
+    ThreadingModel threading = THREADING_ROLES;
+    std::vector<int> cpus;        // Núcleos em que as threads são fixadas (vazio = livres)
+    int rt_priority = 0;          // > 0: SCHED_FIFO com essa prioridade
+    int nice_value = 0;
+    int max_fps = 30;             // Limite de quadros por segundo (0 = sem limite)
+};
+
+// Filas de Input: um produtor (input_loop) e um consumidor (player_step) por jogador
+const std::size_t INPUT_RING_SIZE = 256;
+
+// Tudo que pertence a um jogador da partida
+struct PlayerSlot {
+    // Só o worker que processa o jogador o altera (o PlayerScheduler garante um por vez);
+    // a renderização lê só os snapshots
+    Player player;
+    bool is_bot = false;
+    long next_bot_move = 0; // Tick da próxima jogada do bot
+    long sim_tick = 0;      // Último tick processado (só o worker do jogador usa)
+
+    // Lixo recebido dos oponentes (os ataques do próprio jogador o cancelam antes de sair)
+    GarbageLedger garbage;
+
+    SpscRing<InputEvent, INPUT_RING_SIZE> input_ring;
+    std::vector<InputEvent> inputs; // Comandos retirados da fila num passo, aplicados em ordem de tick
+
+    // Snapshots publicados pelo jogador e lidos pela renderização sem trava
+    TripleBuffer<BoardSnapshot> snapshots;
+    std::uint32_t snapshot_version = 0;
+
+    // Situação vista pelos outros jogadores ao escolher o alvo do lixo
+    std::atomic<bool> alive{true};
+    std::atomic<int> score{0};
+
+    InputLatency latency;
+};
+
+// Estado da renderização entre um quadro e outro (só quem desenha usa)
+struct RenderState {
+    BoardRenderer p1_renderer;
+    BoardRenderer p2_renderer;
+    int last_p1_score = -1;
+    int last_p2_score = -1;
+    int last_alive = -1;
+    std::int8_t last_next[2][PREVIEW_SIZE];
+    std::vector<const BoardSnapshot*> boards; // Snapshots lidos no quadro atual
+    std::vector<std::uint32_t> spectator_versions;
+    SpectatorWriter* spectator_writer = nullptr;
+};
+
 class Game {
 public:
-    Game();
+    explicit Game(const GameOptions& options = GameOptions());
     ~Game();
     void run();
 
@@ -22,33 +126,48 @@ private:
     WINDOW* score_win;
 
     // Estado do Jogo
-    Board p1_board;
-    Board p2_board;
+    GameOptions options;
+    std::vector<std::unique_ptr<PlayerSlot>> slots;
     std::atomic<bool> game_over;
-    int p1_score, p2_score;
+    SimClock clock;
+    long bot_delay_ticks;
+    int wake_fd; // eventfd: acorda a thread de input bloqueada no poll() quando o jogo termina
+    int render_fd; // eventfd: acorda a renderização quando algum snapshot muda (ou no SIGUSR1)
 
-    // Sincronização
-    std::binary_semaphore p1_board_sem{1};
-    std::binary_semaphore p2_board_sem{1};
+    // Renderização guiada por mudanças: cada publicação incrementa frame_epoch, e a
+    // renderização guarda em drawn_epoch o valor que já desenhou (iguais = nada a desenhar)
+    std::atomic<std::uint64_t> frame_epoch{0};
+    std::atomic<std::uint64_t> drawn_epoch{0};
+    GarbageRouter garbage_router;
 
-    // Para o lixo dos jogadores
-    std::counting_semaphore<100> p1_garbage_sem{0};
-    std::counting_semaphore<100> p2_garbage_sem{0};
+    // Gravação do replay (opcional)
+    std::unique_ptr<ReplayRecorder> recorder;
 
-    // Filas de Input
-    std::queue<int> p1_input_queue;
-    std::queue<int> p2_input_queue;
+    // Transmissão para espectadores em outros processos (opcional; só a renderização escreve)
+    std::unique_ptr<SpectatorWriter> spectators;
 
-    std::binary_semaphore p1_input_sem{1}; // Inicializado com 1
-    std::binary_semaphore p2_input_sem{1}; // Inicializado com 1
+    // Bot (só existe se algum jogador for controlado por ele)
+    std::unique_ptr<ThreadPool> bot_pool;
+    std::unique_ptr<Bot> bot;
 
-    // As 4 Threads
+    // Threads: input, renderização e um pool fixo que processa todos os jogadores
     std::thread t_input;
     std::thread t_render;
-    std::thread t_player1;
-    std::thread t_player2;
+    PlayerScheduler scheduler;
+
+    // Modelo reator: próximo prazo de cada jogador (ms do steady_clock, -1 = terminou)
+    std::vector<long> reactor_deadlines;
 
     void input_loop();
+    bool handle_input(bool& stdin_open);
     void render_loop();
-    void player_loop(int player_id);
-};
\ No newline at end of file
+    void request_frame();
+    long frame_interval_ms() const;
+    void init_render_state(RenderState& render);
+    void render_frame(RenderState& render);
+    void reactor_loop();
+    long player_step(int index);
+    void wake_player(int index);
+    void send_garbage(int from, const StepResult& result);
+    void request_stop();
+};
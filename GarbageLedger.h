@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Board.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lixo pendente de um jogador: os ataques dos oponentes chegam como pacotes
+// numa fila lock-free de múltiplos produtores (qualquer jogador pode atacar) e
+// um consumidor (o próprio jogador, que os aplica ou cancela).
+// A fila é limitada; se encher, as linhas excedentes vão para um contador e
+// chegam depois como um pacote com buraco sorteado, então nenhuma linha se perde.
+class GarbageLedger {
+public:
+    static const std::size_t CAPACITY = 64;
+
+    GarbageLedger() {
+        clear();
+    }
+
+    /// @brief (Produtor, qualquer thread) Enfileira um ataque sem bloquear
+    void push(const GarbagePacket& packet) {
+        if (packet.lines <= 0) return;
+        pending_lines.fetch_add(packet.lines, std::memory_order_relaxed);
+
+        // Fila limitada de Vyukov: cada célula guarda a volta em que pode ser escrita
+        std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & (CAPACITY - 1)];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                overflow_lines.fetch_add(packet.lines, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->packet = packet;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    /// @brief (Consumidor) Usa as linhas de um ataque próprio para cancelar lixo pendente,
+    /// começando pelos pacotes mais antigos
+    /// @param lines Linhas de lixo que o jogador ia enviar
+    /// @return Linhas que sobraram para enviar aos oponentes
+    int cancel(int lines) {
+        GarbagePacket packet;
+        while (lines > 0 && pop(packet)) {
+            int cancelled = (packet.lines < lines) ? packet.lines : lines;
+            packet.lines -= cancelled;
+            lines -= cancelled;
+            pending_lines.fetch_sub(cancelled, std::memory_order_relaxed);
+            if (packet.lines > 0) {
+                held = packet;
+                has_held = true;
+            }
+        }
+        return lines;
+    }
+
+    /// @brief (Consumidor) Retira os ataques pendentes, na ordem de chegada
+    /// @param out Destino
+    /// @param max Capacidade de out
+    /// @return Número de pacotes retirados
+    int take(GarbagePacket* out, int max) {
+        int count = 0;
+        while (count < max && pop(out[count])) {
+            pending_lines.fetch_sub(out[count].lines, std::memory_order_relaxed);
+            count++;
+        }
+        return count;
+    }
+
+    /// @brief Linhas pendentes (aproximado; qualquer thread pode ler)
+    int get_pending_lines() const {
+        return pending_lines.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Descarta tudo; só pode ser chamado sem produtores ativos
+    void clear() {
+        for (std::size_t i = 0; i < CAPACITY; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos.store(0, std::memory_order_relaxed);
+        dequeue_pos = 0;
+        pending_lines.store(0, std::memory_order_relaxed);
+        overflow_lines.store(0, std::memory_order_relaxed);
+        has_held = false;
+    }
+
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY deve ser potência de 2");
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        GarbagePacket packet;
+    };
+
+    Cell cells[CAPACITY];
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_pos;
+    alignas(CACHE_LINE_SIZE) std::atomic<int> pending_lines;
+    std::atomic<int> overflow_lines;
+
+    // Só o consumidor usa
+    alignas(CACHE_LINE_SIZE) std::size_t dequeue_pos;
+    GarbagePacket held; // Resto de um pacote cancelado em parte
+    bool has_held;
+
+    bool pop(GarbagePacket& out) {
+        if (has_held) {
+            out = held;
+            has_held = false;
+            return true;
+        }
+        Cell& cell = cells[dequeue_pos & (CAPACITY - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) == dequeue_pos + 1) {
+            out = cell.packet;
+            cell.sequence.store(dequeue_pos + CAPACITY, std::memory_order_release);
+            dequeue_pos++;
+            return true;
+        }
+        int overflow = overflow_lines.exchange(0, std::memory_order_relaxed);
+        if (overflow > 0) {
+            out = {overflow, -1};
+            return true;
+        }
+        return false;
+    }
+};
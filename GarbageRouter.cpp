@@ -0,0 +1,80 @@
+#include "GarbageRouter.h"
+#include <cstring>
+
+GarbageRouter::GarbageRouter(GarbageTargeting mode, std::uint32_t seed) : mode(mode), random_state(seed) {}
+
+GarbageTargeting GarbageRouter::get_mode() const {
+    return mode;
+}
+
+/// @brief Escolhe quem recebe o lixo enviado por um jogador
+/// @param from Índice de quem enviou
+/// @param players Situação de todos os jogadores da partida
+/// @param targets Saída: índices dos destinatários (limpo antes)
+/// @return Número de destinatários (0 se não há oponente vivo)
+int GarbageRouter::pick_targets(int from, const std::vector<PlayerStatus>& players, std::vector<int>& targets) {
+    targets.clear();
+    const int n = static_cast<int>(players.size());
+
+    switch (mode) {
+    case TARGET_NEXT:
+        for (int i = 1; i < n; ++i) {
+            int candidate = (from + i) % n;
+            if (players[candidate].alive) {
+                targets.push_back(candidate);
+                break;
+            }
+        }
+        break;
+
+    case TARGET_RANDOM: {
+        int alive = 0;
+        for (int i = 0; i < n; ++i) {
+            if (i != from && players[i].alive) alive++;
+        }
+        if (alive == 0) break;
+
+        // Hash do contador (splitmix32): sem estado compartilhado além de um fetch_add
+        std::uint32_t z = random_state.fetch_add(0x9E3779B9u, std::memory_order_relaxed);
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        z ^= z >> 16;
+        int pick = static_cast<int>(z % static_cast<std::uint32_t>(alive));
+        for (int i = 0; i < n; ++i) {
+            if (i != from && players[i].alive && pick-- == 0) {
+                targets.push_back(i);
+                break;
+            }
+        }
+        break;
+    }
+
+    case TARGET_LEADER: {
+        int best = -1;
+        for (int i = 0; i < n; ++i) {
+            if (i == from || !players[i].alive) continue;
+            if (best < 0 || players[i].score > players[best].score) best = i;
+        }
+        if (best >= 0) targets.push_back(best);
+        break;
+    }
+
+    case TARGET_ALL:
+        for (int i = 0; i < n; ++i) {
+            if (i != from && players[i].alive) targets.push_back(i);
+        }
+        break;
+    }
+    return static_cast<int>(targets.size());
+}
+
+/// @brief Converte o nome de um modo (next, random, leader, all) para o enum
+/// @return false se o nome não é conhecido
+bool parse_targeting(const char* name, GarbageTargeting& mode) {
+    if (std::strcmp(name, "next") == 0) mode = TARGET_NEXT;
+    else if (std::strcmp(name, "random") == 0) mode = TARGET_RANDOM;
+    else if (std::strcmp(name, "leader") == 0) mode = TARGET_LEADER;
+    else if (std::strcmp(name, "all") == 0) mode = TARGET_ALL;
+    else return false;
+    return true;
+}
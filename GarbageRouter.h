@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Para quem vai o lixo gerado por um jogador
+enum GarbageTargeting : int {
+    TARGET_NEXT = 0, // Próximo jogador vivo (em 2 jogadores, o oponente)
+    TARGET_RANDOM,   // Um oponente vivo sorteado
+    TARGET_LEADER,   // O oponente vivo com maior pontuação
+    TARGET_ALL       // Todos os oponentes vivos recebem a quantidade inteira
+};
+
+// Situação de um jogador vista pelo roteador de lixo
+struct PlayerStatus {
+    bool alive;
+    int score;
+};
+
+// Escolhe os destinatários do lixo numa partida com N jogadores.
+// pick_targets pode ser chamado de várias threads ao mesmo tempo.
+class GarbageRouter {
+public:
+    explicit GarbageRouter(GarbageTargeting mode = TARGET_NEXT, std::uint32_t seed = 1);
+
+    int pick_targets(int from, const std::vector<PlayerStatus>& players, std::vector<int>& targets);
+    GarbageTargeting get_mode() const;
+
+private:
+    GarbageTargeting mode;
+    std::atomic<std::uint32_t> random_state;
+};
+
+bool parse_targeting(const char* name, GarbageTargeting& mode);
@@ -0,0 +1,144 @@
+#include "Match.h"
+#include "Replay.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Driver headless: roda partidas sem terminal, avançando os ticks da simulação
+// (SimClock.h) o mais rápido que a CPU permitir.
+//
+// Uso: tetris_headless [--games N] [--seed S] [--action-ticks T] [--max-ticks T]
+//                       [--bot-depth D] [--threads N] [--level L]
+//                       [--players N] [--targeting next|random|leader|all]
+//                       [--record ARQUIVO] [--shared-seed]
+//
+// Cada jogador age a cada --action-ticks ticks: sem --bot-depth, com um comando
+// aleatório; com ele, como bot que coloca uma peça buscando D peças à frente.
+// --level é o nível inicial da curva de velocidade da gravidade.
+// Com --record, a primeira partida é gravada em replay. Com --shared-seed,
+// todos os jogadores recebem a mesma sequência de peças.
+
+static const Command RANDOM_COMMANDS[] = {CMD_NONE, CMD_LEFT, CMD_RIGHT, CMD_ROTATE, CMD_DOWN};
+
+int main(int argc, char** argv) {
+    long games = 1000;
+    unsigned seed = 1;
+    long action_ticks = 3;    // ~50 ms entre ações de cada jogador
+    long max_ticks = 300000;  // Limite de segurança por partida (~83 min de jogo)
+    int bot_depth = 0;
+    unsigned threads = 0;     // 0 = um por núcleo
+    int num_players = 2;
+    GarbageTargeting targeting = TARGET_NEXT;
+    const char* record_path = nullptr;
+    bool shared_seed = false;
+    SpeedCurve curve;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--shared-seed") == 0) {
+            shared_seed = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Opção sem valor: %s\n", argv[i]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--games") == 0) games = std::atol(value);
+        else if (std::strcmp(argv[i - 1], "--seed") == 0) seed = static_cast<unsigned>(std::atol(value));
+        else if (std::strcmp(argv[i - 1], "--action-ticks") == 0) action_ticks = std::atol(value);
+        else if (std::strcmp(argv[i - 1], "--level") == 0) curve.start_level = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--max-ticks") == 0) max_ticks = std::atol(value);
+        else if (std::strcmp(argv[i - 1], "--bot-depth") == 0) bot_depth = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--threads") == 0) threads = static_cast<unsigned>(std::atol(value));
+        else if (std::strcmp(argv[i - 1], "--players") == 0) num_players = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--record") == 0) record_path = value;
+        else if (std::strcmp(argv[i - 1], "--targeting") == 0) {
+            if (!parse_targeting(value, targeting)) {
+                std::fprintf(stderr, "Modo de lixo desconhecido: %s\n", value);
+                return 1;
+            }
+        } else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", argv[i - 1]);
+            return 1;
+        }
+    }
+
+    std::srand(seed);
+
+    if (num_players < 1) num_players = 1;
+    if (action_ticks < 1) action_ticks = 1;
+    std::vector<long> wins(num_players, 0);
+    long draws = 0;
+    long long total_ticks = 0;
+    long long total_score = 0;
+    long long total_sent = 0;
+
+    ThreadPool pool(threads);
+    Bot bot(pool, bot_depth);
+
+    auto start = std::chrono::steady_clock::now();
+    Match match(num_players, targeting, shared_seed, curve);
+    for (long g = 0; g < games; ++g) {
+        long tick = 0;
+        match.reset(tick, seed + static_cast<unsigned>(g));
+
+        std::unique_ptr<ReplayRecorder> recorder;
+        if (g == 0 && record_path) {
+            // Sem tempo real a cumprir: a simulação espera a gravação em vez de perder registros
+            recorder = std::make_unique<ReplayRecorder>(record_path, match.get_seeds(), curve, tick, true);
+            if (!recorder->is_open()) {
+                std::fprintf(stderr, "Não foi possível criar %s\n", record_path);
+                return 1;
+            }
+            match.attach_recorder(recorder.get());
+        }
+        while (!match.is_over() && tick < max_ticks) {
+            if (tick % action_ticks == 0) {
+                for (int p = 0; p < num_players; ++p) {
+                    if (bot_depth > 0) match.play_bot(p, bot, tick);
+                    else match.apply_command(p, RANDOM_COMMANDS[std::rand() % 5], tick);
+                }
+            }
+            tick++;
+            match.update(tick);
+        }
+
+        if (recorder) {
+            for (int p = 0; p < num_players; ++p) recorder->record_end(p, match.get_player(p), tick);
+            recorder->close();
+            match.attach_recorder(nullptr);
+            if (recorder->get_dropped_events() > 0) {
+                std::fprintf(stderr, "Replay incompleto: %ld registros perdidos\n", recorder->get_dropped_events());
+                return 1;
+            }
+        }
+
+        int winner = match.get_winner();
+        if (winner >= 0) wins[winner]++;
+        else draws++;
+        total_ticks += tick;
+        for (int p = 0; p < num_players; ++p) {
+            total_score += match.get_player(p).get_score();
+            total_sent += match.get_lines_sent(p);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("partidas: %ld\n", games);
+    std::printf("jogadores: %d\n", num_players);
+    std::printf("vitorias:");
+    for (int p = 0; p < num_players; ++p) std::printf(" J%d %ld,", p + 1, wins[p]);
+    std::printf(" empates %ld\n", draws);
+    std::printf("ticks: %lld (%.1f por partida)\n", total_ticks, games > 0 ? double(total_ticks) / games : 0.0);
+    std::printf("pontuacao media: %.1f, lixo enviado medio: %.2f\n",
+                games > 0 ? double(total_score) / games : 0.0,
+                games > 0 ? double(total_sent) / games : 0.0);
+    std::printf("tempo: %.3f s, %.0f partidas/s, %.0f ticks/s\n", seconds,
+                seconds > 0 ? games / seconds : 0.0,
+                seconds > 0 ? total_ticks / seconds : 0.0);
+    std::printf("tempo simulado: %.1f s, %.0fx o tempo real\n", double(total_ticks) / TICKS_PER_SECOND,
+                seconds > 0 ? double(total_ticks) / TICKS_PER_SECOND / seconds : 0.0);
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "Match.h"
+
+Match::Match(int num_players, GarbageTargeting targeting, bool shared_seed, const SpeedCurve& curve)
+    : players(num_players < 1 ? 1 : num_players, Player(curve)),
+      lines_sent(players.size(), 0),
+      alive_count(static_cast<int>(players.size())),
+      seeds(players.size(), 0),
+      shared_seed(shared_seed),
+      router(targeting),
+      status(players.size()) {
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        garbage.push_back(std::make_unique<GarbageLedger>());
+    }
+    reset(0, 1);
+}
+
+/// @brief Reinicia os tabuleiros e zera o lixo pendente
+/// @param tick Tick inicial da partida
+/// @param seed Seed da partida (a mesma seed repete a partida, dados os mesmos comandos)
+void Match::reset(long tick, std::uint32_t seed) {
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        seeds[i] = shared_seed ? seed : player_seed(seed, static_cast<int>(i));
+        players[i].reset(tick, seeds[i]);
+        garbage[i]->clear();
+        lines_sent[i] = 0;
+    }
+    alive_count = static_cast<int>(players.size());
+}
+
+/// @brief Grava no replay tudo que acontece com os jogadores
+/// @param recorder Gravador (nullptr para parar de gravar)
+void Match::attach_recorder(ReplayRecorder* recorder) {
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        players[i].attach_recorder(recorder, static_cast<int>(i));
+    }
+}
+
+const std::vector<std::uint32_t>& Match::get_seeds() const {
+    return seeds;
+}
+
+/// @brief Recalcula quantos jogadores continuam vivos
+void Match::refresh_alive() {
+    alive_count = 0;
+    for (const Player& p : players) {
+        if (!p.is_game_over()) alive_count++;
+    }
+}
+
+/// @brief Encaminha o lixo gerado por um jogador para os alvos escolhidos pelo roteador
+/// @param from Índice do jogador que limpou linhas
+/// @param result Resultado da fixação da peça
+void Match::send_garbage(int from, const StepResult& result) {
+    if (result.piece_fixed && players[from].is_game_over()) refresh_alive();
+    if (result.garbage_to_send <= 0) return;
+
+    // O ataque primeiro cancela o lixo que o próprio jogador tem pendente
+    int lines = garbage[from]->cancel(result.garbage_to_send);
+    if (lines <= 0) return;
+
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        status[i].alive = !players[i].is_game_over();
+        status[i].score = players[i].get_score();
+    }
+    router.pick_targets(from, status, targets);
+    for (int target : targets) {
+        garbage[target]->push({lines, result.garbage_hole});
+        lines_sent[from] += lines;
+    }
+}
+
+/// @brief Aplica um comando de um jogador
+/// @param player Índice do jogador
+/// @param cmd Comando a ser aplicado
+/// @param tick Tick atual
+void Match::apply_command(int player, Command cmd, long tick) {
+    if (is_over() || players[player].is_game_over()) return;
+    send_garbage(player, players[player].apply_command(cmd, tick));
+}
+
+/// @brief Deixa o bot escolher e fixar a peça atual de um jogador
+/// @param player Índice do jogador
+/// @param bot Bot que controla o jogador
+/// @param tick Tick atual
+void Match::play_bot(int player, const Bot& bot, long tick) {
+    if (is_over() || players[player].is_game_over()) return;
+    Placement placement = bot.choose(players[player].get_board());
+    send_garbage(player, Bot::execute(players[player], placement, tick));
+}
+
+/// @brief Avança a partida: entrega o lixo pendente e processa a gravidade
+/// @param tick Tick atual; as quedas vencidas desde a última chamada acontecem
+/// cada uma no seu tick (chamar a cada tick mantém tudo em ordem de tick)
+void Match::update(long tick) {
+    for (std::size_t i = 0; i < players.size() && !is_over(); ++i) {
+        if (players[i].is_game_over()) continue;
+        GarbagePacket incoming[GarbageLedger::CAPACITY];
+        int count = garbage[i]->take(incoming, GarbageLedger::CAPACITY);
+        if (count > 0) {
+            players[i].receive_garbage(incoming, count, tick);
+            if (players[i].is_game_over()) {
+                refresh_alive();
+                continue;
+            }
+        }
+        while (!players[i].is_game_over() && players[i].next_drop_tick() <= tick) {
+            send_garbage(static_cast<int>(i), players[i].update_gravity(tick));
+        }
+    }
+}
+
+/// @brief Tira um jogador da partida, como se ele tivesse perdido (o cliente desconectou)
+/// @param player Índice do jogador
+void Match::resign(int player) {
+    if (players[player].is_game_over()) return;
+    players[player].get_board().set_game_over(true);
+    garbage[player]->clear();
+    refresh_alive();
+}
+
+/// @brief Checa se sobrou no máximo um jogador vivo (ou, jogando sozinho, se ele perdeu)
+bool Match::is_over() const {
+    return players.size() > 1 ? alive_count <= 1 : alive_count == 0;
+}
+
+/// @brief Último jogador vivo, se a partida acabou com um vencedor
+int Match::get_winner() const {
+    if (!is_over() || alive_count != 1) return -1;
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        if (!players[i].is_game_over()) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int Match::get_num_players() const {
+    return static_cast<int>(players.size());
+}
+
+int Match::get_alive_count() const {
+    return alive_count;
+}
+
+const Player& Match::get_player(int player) const {
+    return players[player];
+}
+
+int Match::get_lines_sent(int player) const {
+    return lines_sent[player];
+}
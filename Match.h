@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Bot.h"
+#include "GarbageLedger.h"
+#include "GarbageRouter.h"
+#include <memory>
+#include <vector>
+
+// Partida headless: N jogadores e a troca de lixo entre eles.
+// Roda inteiramente na thread do chamador, sem terminal e sem relógio real: o
+// chamador avança os ticks (SimClock.h) tão rápido quanto quiser.
+// A partida acaba quando sobra no máximo um jogador vivo.
+class Match {
+public:
+    // shared_seed: todos os jogadores recebem a mesma sequência de peças
+    explicit Match(int num_players = 2, GarbageTargeting targeting = TARGET_NEXT, bool shared_seed = false,
+                   const SpeedCurve& curve = SpeedCurve());
+    void reset(long tick, std::uint32_t seed);
+    void attach_recorder(ReplayRecorder* recorder);
+
+    void apply_command(int player, Command cmd, long tick);
+    void play_bot(int player, const Bot& bot, long tick);
+    void update(long tick);
+    void resign(int player); // O jogador sai da partida (não é gravado no replay)
+
+    bool is_over() const;
+    int get_winner() const; // -1 para empate ou partida em andamento
+    int get_num_players() const;
+    int get_alive_count() const;
+    const Player& get_player(int player) const;
+    const std::vector<std::uint32_t>& get_seeds() const;
+    int get_lines_sent(int player) const;
+
+private:
+    std::vector<Player> players;
+    std::vector<std::unique_ptr<GarbageLedger>> garbage; // Lixo pendente de cada jogador
+    std::vector<int> lines_sent;
+    int alive_count;
+    std::vector<std::uint32_t> seeds;
+    bool shared_seed;
+
+    GarbageRouter router;
+    std::vector<PlayerStatus> status; // Reaproveitados a cada envio de lixo
+    std::vector<int> targets;
+
+    void send_garbage(int from, const StepResult& result);
+    void refresh_alive();
+};
@@ -0,0 +1,464 @@
+#include "MatchServer.h"
+#include "CpuAffinity.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Bytes ainda não enviados a um cliente a partir dos quais ele é desconectado
+const std::size_t SERVER_MAX_BACKLOG = 256 * 1024;
+
+/// @brief Relógio em ns, o mesmo dos SimClock das partidas
+static long long now_ns() {
+    return SimClock::steady_ns();
+}
+
+/// @brief Cria o socket, o epoll e o pool das partidas (os workers começam em run())
+MatchServer::MatchServer(const ServerOptions& options)
+    : options(options),
+      listen_fd(-1),
+      epoll_fd(epoll_create1(EPOLL_CLOEXEC)),
+      wake_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      path(server_socket_path(options.socket_path)),
+      scheduler(options.max_matches < 1 ? 1 : options.max_matches, [this](int index) { return step_match(index); }) {
+    if (this->options.max_matches < 1) this->options.max_matches = 1;
+    // Os workers começam olhando todos os índices, então as partidas já existem antes deles
+    for (int i = 0; i < this->options.max_matches; ++i) matches.push_back(std::make_unique<ServerMatch>());
+    for (int i = this->options.max_matches - 1; i >= 0; --i) free_matches.push_back(i);
+    if (epoll_fd < 0 || wake_fd < 0) return;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return;
+    unlink(path.c_str()); // Socket que sobrou de um servidor anterior
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return;
+    }
+    listen_fd = fd;
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+    ev.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+}
+
+MatchServer::~MatchServer() {
+    scheduler.stop();
+    for (std::size_t fd = 0; fd < connections.size(); ++fd) {
+        if (connections[fd]) close(static_cast<int>(fd));
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        unlink(path.c_str());
+    }
+    if (wake_fd >= 0) close(wake_fd);
+    if (epoll_fd >= 0) close(epoll_fd);
+}
+
+bool MatchServer::is_open() const {
+    return listen_fd >= 0;
+}
+
+const ServerStats& MatchServer::get_stats() const {
+    return stats;
+}
+
+/// @brief Pede para run() retornar (só usa operações seguras em handlers de sinal)
+void MatchServer::stop() {
+    stopping.store(true, std::memory_order_relaxed);
+    std::uint64_t one = 1;
+    ssize_t written = write(wake_fd, &one, sizeof(one));
+    (void)written; // Só falha se o contador já estiver cheio, e aí o despertar já está pendente
+}
+
+/// @brief Laço de I/O: roda na thread chamadora até stop()
+void MatchServer::run() {
+    scheduler.start(options.workers, options.cpus);
+
+    epoll_event events[256];
+    while (!stopping.load(std::memory_order_relaxed)) {
+        int n = epoll_wait(epoll_fd, events, 256, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listen_fd) {
+                accept_clients();
+            } else if (fd == wake_fd) {
+                std::uint64_t count;
+                ssize_t got = read(wake_fd, &count, sizeof(count));
+                (void)got;
+                drain_outbox();
+            } else if (static_cast<std::size_t>(fd) < connections.size() && connections[fd]) {
+                Connection& conn = *connections[fd];
+                if (events[i].events & EPOLLOUT) flush(conn);
+                if (connections[fd] && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) read_client(conn);
+            }
+        }
+
+        // Um notify por partida para todos os comandos lidos nesta volta
+        for (int index : woken_matches) {
+            matches[index]->wake = false;
+            scheduler.notify(index);
+        }
+        woken_matches.clear();
+
+        // Um write() por conexão para todas as mensagens acumuladas nesta volta
+        for (int fd : dirty_connections) {
+            if (static_cast<std::size_t>(fd) < connections.size() && connections[fd]) {
+                connections[fd]->dirty = false;
+                flush(*connections[fd]);
+            }
+        }
+        dirty_connections.clear();
+    }
+}
+
+/// @brief Aceita todas as conexões pendentes
+void MatchServer::accept_clients() {
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            return; // EAGAIN, ou sem descritores livres: tenta de novo na próxima volta
+        }
+        if (static_cast<std::size_t>(fd) >= connections.size()) connections.resize(fd + 1);
+        connections[fd] = std::make_unique<Connection>();
+        connections[fd]->fd = fd;
+        stats.connections++;
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+/// @brief Lê tudo que o cliente mandou e processa as mensagens completas
+void MatchServer::read_client(Connection& conn) {
+    const int fd = conn.fd;
+    std::uint8_t buffer[4096];
+    while (true) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            conn.parser.feed(buffer, static_cast<std::size_t>(n));
+            if (static_cast<std::size_t>(n) < sizeof(buffer)) break;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == EAGAIN) break;
+        close_client(fd); // EOF ou erro
+        return;
+    }
+
+    MessageType type;
+    const std::uint8_t* body;
+    std::size_t size;
+    while (conn.parser.next(type, body, size)) {
+        if (!handle_message(conn, type, body, size)) {
+            close_client(fd); // Mensagem inválida
+            return;
+        }
+    }
+}
+
+/// @brief Trata uma mensagem de um cliente
+/// @return false se a mensagem é inválida (o cliente é desconectado)
+bool MatchServer::handle_message(Connection& conn, MessageType type, const std::uint8_t* body, std::size_t size) {
+    MessageReader reader(body, size);
+    if (type == MSG_JOIN) {
+        std::uint16_t version;
+        std::uint8_t num_players;
+        if (!reader.u16(version) || !reader.u8(num_players)) return false;
+        if (version != SERVER_PROTOCOL_VERSION || num_players < 1 || num_players > SERVER_MAX_PLAYERS) return false;
+        if (conn.match >= 0 || conn.waiting_for > 0) return true; // Já está numa partida ou na fila
+        join_queue(conn, num_players);
+        return true;
+    }
+    if (type == MSG_INPUT) {
+        std::uint8_t cmd;
+        if (!reader.u8(cmd) || cmd > CMD_HARD_DROP) return false;
+        if (conn.match < 0) return true; // Comando fora de partida (chegou depois do fim)
+        ServerMatch& m = *matches[conn.match];
+        stats.inputs++;
+        if (!m.seats[conn.seat].inputs.try_push({static_cast<Command>(cmd), conn.seat, m.serial, now_ns()})) {
+            stats.inputs_dropped++;
+            return true;
+        }
+        if (!m.wake) {
+            m.wake = true;
+            woken_matches.push_back(conn.match);
+        }
+        return true;
+    }
+    return false;
+}
+
+/// @brief Põe o cliente na fila e começa as partidas que ficaram completas
+void MatchServer::join_queue(Connection& conn, int num_players) {
+    conn.waiting_for = num_players;
+    waiting[num_players].push_back(conn.fd);
+    start_matches();
+}
+
+/// @brief Começa uma partida para cada fila com jogadores suficientes, enquanto houver índices livres
+void MatchServer::start_matches() {
+    for (int n = 1; n <= SERVER_MAX_PLAYERS; ++n) {
+        std::vector<int>& queue = waiting[n];
+        std::size_t used = 0;
+        while (queue.size() - used >= static_cast<std::size_t>(n) && !free_matches.empty()) {
+            start_match(n, queue.data() + used);
+            used += n;
+        }
+        queue.erase(queue.begin(), queue.begin() + static_cast<std::ptrdiff_t>(used));
+    }
+}
+
+/// @brief Monta uma partida num índice livre e a entrega aos workers
+/// @param num_players Tamanho da partida
+/// @param fds Conexão de cada assento
+void MatchServer::start_match(int num_players, const int* fds) {
+    int index = free_matches.back();
+    free_matches.pop_back();
+    ServerMatch& m = *matches[index];
+
+    // O worker só volta a ver a partida depois do resume(), que publica tudo isto
+    m.serial = ++next_serial;
+    if (!m.match || m.num_players != num_players) {
+        m.match = std::make_unique<Match>(num_players, options.targeting, false, options.speed_curve);
+    }
+    m.num_players = num_players;
+    std::uint32_t seed = options.seed != 0 ? options.seed + m.serial : static_cast<std::uint32_t>(now_ns());
+    m.match->reset(0, seed);
+    m.clock = SimClock(options.time_scale);
+    m.clock.start();
+    m.sim_tick = 0;
+    m.current.resize(num_players);
+    m.sent.resize(num_players);
+    for (BoardSnapshot& snapshot : m.sent) clear_sent_snapshot(snapshot);
+
+    std::vector<std::uint8_t> start;
+    for (int seat = 0; seat < num_players; ++seat) {
+        m.seats[seat].fd = fds[seat];
+        m.seats[seat].resigned.store(false, std::memory_order_relaxed);
+        Connection& conn = *connections[fds[seat]];
+        conn.waiting_for = 0;
+        conn.match = index;
+        conn.seat = seat;
+
+        start.clear();
+        MessageWriter writer(start);
+        writer.begin(MSG_START);
+        writer.u32(m.serial);
+        writer.u32(seed);
+        writer.u8(static_cast<std::uint8_t>(seat));
+        writer.u8(static_cast<std::uint8_t>(num_players));
+        writer.end();
+        send(conn, start.data(), start.size());
+    }
+    m.running.store(true, std::memory_order_release);
+
+    stats.matches_started++;
+    active_matches++;
+    stats.peak_matches = std::max(stats.peak_matches, active_matches);
+    scheduler.resume(index);
+}
+
+/// @brief Copia as mensagens dos workers para as conexões de cada partida
+/// e libera os índices das partidas que terminaram
+void MatchServer::drain_outbox() {
+    drained_bytes.clear();
+    drained_entries.clear();
+    {
+        std::lock_guard<std::mutex> lock(outbox_mutex);
+        outbox_bytes.swap(drained_bytes);
+        outbox_entries.swap(drained_entries);
+    }
+
+    bool freed = false;
+    for (const OutboxEntry& entry : drained_entries) {
+        ServerMatch& m = *matches[entry.match];
+        for (int seat = 0; seat < m.num_players; ++seat) {
+            int fd = m.seats[seat].fd;
+            if (fd < 0 || !connections[fd]) continue;
+            send(*connections[fd], drained_bytes.data() + entry.offset, entry.size);
+        }
+        if (!entry.finished) continue;
+
+        // O cliente pode pedir outra partida com um novo MSG_JOIN
+        for (int seat = 0; seat < m.num_players; ++seat) {
+            int fd = m.seats[seat].fd;
+            m.seats[seat].fd = -1;
+            if (fd < 0 || !connections[fd]) continue;
+            connections[fd]->match = -1;
+            connections[fd]->seat = -1;
+        }
+        free_matches.push_back(entry.match);
+        stats.matches_finished++;
+        active_matches--;
+        freed = true;
+    }
+    if (freed) start_matches();
+}
+
+/// @brief Acrescenta mensagens à saída de uma conexão (enviadas no fim da volta do epoll)
+void MatchServer::send(Connection& conn, const std::uint8_t* data, std::size_t size) {
+    conn.out.insert(conn.out.end(), data, data + size);
+    stats.messages_sent++;
+    // Com EPOLLOUT registrado, o envio espera o socket, a não ser que o cliente já esteja atrasado demais
+    if (!conn.dirty && (!conn.want_write || conn.out.size() - conn.out_pos > SERVER_MAX_BACKLOG)) {
+        conn.dirty = true;
+        dirty_connections.push_back(conn.fd);
+    }
+}
+
+/// @brief Envia o que estiver pendente; o resto espera o socket ficar gravável
+void MatchServer::flush(Connection& conn) {
+    while (conn.out_pos < conn.out.size()) {
+        ssize_t n = write(conn.fd, conn.out.data() + conn.out_pos, conn.out.size() - conn.out_pos);
+        if (n > 0) {
+            conn.out_pos += static_cast<std::size_t>(n);
+            stats.bytes_sent += n;
+            stats.writes++;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == EAGAIN) break;
+        close_client(conn.fd);
+        return;
+    }
+
+    const bool pending = conn.out_pos < conn.out.size();
+    if (!pending) {
+        conn.out.clear();
+        conn.out_pos = 0;
+    } else if (conn.out.size() - conn.out_pos > SERVER_MAX_BACKLOG) {
+        stats.slow_clients++;
+        close_client(conn.fd);
+        return;
+    }
+    if (pending != conn.want_write) {
+        conn.want_write = pending;
+        epoll_event ev{};
+        ev.events = pending ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        ev.data.fd = conn.fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn.fd, &ev);
+    }
+}
+
+/// @brief Desconecta um cliente: tira da fila ou abandona a partida em que ele estava
+void MatchServer::close_client(int fd) {
+    std::unique_ptr<Connection> conn = std::move(connections[fd]);
+    if (!conn) return;
+    if (conn->waiting_for > 0) {
+        std::vector<int>& queue = waiting[conn->waiting_for];
+        queue.erase(std::remove(queue.begin(), queue.end(), fd), queue.end());
+    }
+    if (conn->match >= 0) {
+        ServerMatch& m = *matches[conn->match];
+        m.seats[conn->seat].fd = -1;
+        m.seats[conn->seat].resigned.store(true, std::memory_order_release);
+        scheduler.notify(conn->match);
+    }
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+}
+
+/// @brief Entrega as mensagens de um passo para a thread de I/O
+/// @param index Partida que gerou as mensagens
+/// @param bytes Mensagens completas
+/// @param finished A partida acabou (o worker não toca mais nela até o próximo resume())
+void MatchServer::post(int index, const std::vector<std::uint8_t>& bytes, bool finished) {
+    bool was_empty;
+    {
+        std::lock_guard<std::mutex> lock(outbox_mutex);
+        was_empty = outbox_entries.empty();
+        outbox_entries.push_back({index, outbox_bytes.size(), bytes.size(), finished});
+        outbox_bytes.insert(outbox_bytes.end(), bytes.begin(), bytes.end());
+    }
+    // Só a primeira entrada de um lote acorda a thread de I/O
+    if (was_empty) {
+        std::uint64_t one = 1;
+        ssize_t written = write(wake_fd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+/// @brief Um passo de uma partida, executado por um worker do scheduler: aplica os
+/// comandos no tick em que foram lidos, avança a gravidade até o tick atual e
+/// publica o delta do estado
+/// @param index Índice da partida
+/// @return Próximo prazo (ms do steady_clock), ou -1 se o índice está livre
+long MatchServer::step_match(int index) {
+    ServerMatch& m = *matches[index];
+    if (!m.running.load(std::memory_order_acquire)) return -1;
+    Match& match = *m.match;
+    const long now = m.clock.now();
+
+    // 1. Comandos de todos os assentos, em ordem de leitura
+    m.pending.clear();
+    for (int seat = 0; seat < m.num_players; ++seat) {
+        m.seats[seat].inputs.drain([&](const SeatInput& input) {
+            if (input.serial == m.serial) m.pending.push_back(input); // Senão, sobrou de uma partida anterior
+        });
+    }
+    std::stable_sort(m.pending.begin(), m.pending.end(),
+                     [](const SeatInput& a, const SeatInput& b) { return a.read_ns < b.read_ns; });
+    for (const SeatInput& input : m.pending) {
+        long tick = m.clock.tick_at(input.read_ns);
+        if (tick < m.sim_tick) tick = m.sim_tick;
+        if (tick > now) tick = now;
+        match.update(tick);
+        match.apply_command(input.seat, input.cmd, tick);
+        m.sim_tick = tick;
+    }
+
+    // 2. Quem desconectou sai da partida
+    for (int seat = 0; seat < m.num_players; ++seat) {
+        if (m.seats[seat].resigned.exchange(false, std::memory_order_acquire)) match.resign(seat);
+    }
+
+    // 3. Gravidade e lixo até o tick atual
+    match.update(now);
+    m.sim_tick = now;
+
+    // 4. Delta do estado (uma mensagem para todos os assentos) e, se acabou, o resultado
+    for (int i = 0; i < m.num_players; ++i) fill_snapshot(m.current[i], match.get_player(i), 0);
+    m.out.clear();
+    MessageWriter writer(m.out);
+    encode_state_delta(writer, now, m.current, m.sent);
+    const bool over = match.is_over();
+    if (over) {
+        writer.begin(MSG_END);
+        writer.u32(m.serial);
+        writer.u8(static_cast<std::uint8_t>(match.get_winner()));
+        writer.u32(static_cast<std::uint32_t>(now));
+        writer.end();
+        m.running.store(false, std::memory_order_relaxed); // Antes do post(): depois dele o índice pode ser reaproveitado
+    }
+    if (!m.out.empty()) post(index, m.out, over);
+    if (over) return -1;
+
+    // 5. Próxima queda da gravidade (comandos e desconexões acordam antes pelo notify)
+    long deadline = LONG_MAX;
+    for (int i = 0; i < m.num_players; ++i) {
+        const Player& player = match.get_player(i);
+        if (!player.is_game_over()) deadline = std::min(deadline, player.next_drop_tick());
+    }
+    return m.clock.tick_deadline_ms(deadline);
+}
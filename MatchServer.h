@@ -0,0 +1,154 @@
+#pragma once
+
+#include "GarbageRouter.h"
+#include "Match.h"
+#include "PlayerScheduler.h"
+#include "ServerProtocol.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Servidor de partidas local (tetris_server): centenas de partidas num único
+// processo, com os jogadores conectados por sockets Unix (ServerProtocol.h).
+//
+// Uma única thread (run) faz todo o I/O num epoll: aceita conexões, lê os
+// comandos, monta as partidas e escreve o estado para os clientes. Cada
+// partida é um índice do PlayerScheduler: os workers avançam a simulação no
+// tick do relógio real, aplicam os comandos recebidos e geram um delta do
+// estado por passo, que a thread de I/O copia para todos os assentos da
+// partida e envia num único write() por conexão.
+struct ServerOptions {
+    const char* socket_path = nullptr; // nullptr = server_socket_path()
+    unsigned workers = 0;              // Threads que simulam as partidas (0 = uma por núcleo)
+    int max_matches = 1024;            // Partidas simultâneas; clientes além disso esperam na fila
+    std::uint32_t seed = 0;            // Seed base das partidas (0 = usa o relógio)
+    double time_scale = 1.0;
+    SpeedCurve speed_curve;
+    GarbageTargeting targeting = TARGET_NEXT;
+    std::vector<int> cpus;             // Núcleos dos workers, em rodízio (vazio = livres)
+};
+
+// Contadores do servidor (lidos depois de run())
+struct ServerStats {
+    long long connections = 0;
+    long long matches_started = 0;
+    long long matches_finished = 0;
+    long long inputs = 0;
+    long long inputs_dropped = 0; // Fila do assento cheia
+    long long messages_sent = 0;
+    long long bytes_sent = 0;
+    long long writes = 0;         // Chamadas de write() (cada uma leva um lote de mensagens)
+    long long slow_clients = 0;   // Desconectados por não lerem o estado a tempo
+    int peak_matches = 0;
+};
+
+class MatchServer {
+public:
+    explicit MatchServer(const ServerOptions& options = ServerOptions());
+    ~MatchServer();
+
+    MatchServer(const MatchServer&) = delete;
+    MatchServer& operator=(const MatchServer&) = delete;
+
+    bool is_open() const;
+    void run();
+    void stop(); // Pode ser chamado de um handler de sinal
+    const ServerStats& get_stats() const;
+
+private:
+    // Comando de um assento, carimbado pela thread de I/O
+    struct SeatInput {
+        Command cmd;
+        int seat;
+        std::uint32_t serial; // Partida a que o comando pertence (o índice é reaproveitado)
+        long long read_ns;
+    };
+
+    struct Seat {
+        int fd = -1; // Conexão do jogador (-1 = desconectou; só a thread de I/O usa)
+        SpscRing<SeatInput, 32> inputs;
+        std::atomic<bool> resigned{false};
+    };
+
+    struct ServerMatch {
+        // Escritos pela thread de I/O antes de resume(); depois, só o worker usa
+        std::uint32_t serial = 0;
+        int num_players = 0;
+        std::unique_ptr<Match> match;
+        SimClock clock;
+        std::atomic<bool> running{false}; // Os workers leem em qualquer índice, mesmo livre
+        Seat seats[SERVER_MAX_PLAYERS];
+
+        // Só o worker usa
+        long sim_tick = 0;
+        std::vector<BoardSnapshot> current;
+        std::vector<BoardSnapshot> sent;  // Último estado enviado (base dos deltas)
+        std::vector<SeatInput> pending;   // Comandos retirados das filas num passo
+        std::vector<std::uint8_t> out;    // Mensagens geradas num passo
+
+        bool wake = false; // Chegou comando nesta volta do epoll (só a thread de I/O usa)
+    };
+
+    struct Connection {
+        int fd;
+        FrameParser parser;
+        std::vector<std::uint8_t> out;
+        std::size_t out_pos = 0;
+        bool want_write = false; // EPOLLOUT registrado
+        bool dirty = false;      // Tem dados novos para enviar nesta volta
+        int match = -1;
+        int seat = -1;
+        int waiting_for = 0;     // Na fila de uma partida de N jogadores
+    };
+
+    // Mensagens geradas pelos workers e ainda não copiadas para as conexões
+    struct OutboxEntry {
+        int match;
+        std::size_t offset;
+        std::size_t size;
+        bool finished; // Última mensagem da partida
+    };
+
+    ServerOptions options;
+    int listen_fd;
+    int epoll_fd;
+    int wake_fd; // eventfd: mensagens na caixa de saída ou pedido de parada
+    std::atomic<bool> stopping{false};
+    std::string path;
+    ServerStats stats;
+
+    std::vector<std::unique_ptr<Connection>> connections; // Indexadas pelo fd
+    std::vector<std::unique_ptr<ServerMatch>> matches; // Todas criadas no construtor
+    std::vector<int> free_matches;
+    std::vector<int> waiting[SERVER_MAX_PLAYERS + 1]; // Fila de cada tamanho de partida
+    std::vector<int> dirty_connections;
+    std::vector<int> woken_matches;
+    int active_matches = 0;
+    std::uint32_t next_serial = 0;
+
+    std::mutex outbox_mutex;
+    std::vector<std::uint8_t> outbox_bytes;
+    std::vector<OutboxEntry> outbox_entries;
+    std::vector<std::uint8_t> drained_bytes; // Trocados com a caixa de saída a cada leitura
+    std::vector<OutboxEntry> drained_entries;
+
+    PlayerScheduler scheduler;
+
+    // Thread de I/O
+    void accept_clients();
+    void read_client(Connection& conn);
+    bool handle_message(Connection& conn, MessageType type, const std::uint8_t* body, std::size_t size);
+    void join_queue(Connection& conn, int num_players);
+    void start_matches();
+    void start_match(int num_players, const int* fds);
+    void drain_outbox();
+    void send(Connection& conn, const std::uint8_t* data, std::size_t size);
+    void flush(Connection& conn);
+    void close_client(int fd);
+
+    // Workers
+    long step_match(int index);
+    void post(int index, const std::vector<std::uint8_t>& bytes, bool finished);
+};
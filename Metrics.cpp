@@ -0,0 +1,126 @@
+#include "Metrics.h"
+#include <bit>
+#include <chrono>
+#include <cstdio>
+
+static LatencyHistogram METRICS[METRIC_COUNT];
+
+static const char* const METRIC_NAMES[METRIC_COUNT] = {
+    "input_latency_ns",
+    "gravity_jitter_ns",
+    "frame_time_ns",
+};
+
+long long metrics_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// @brief Bucket de um valor: os 4 primeiros são exatos; depois, cada potência
+/// de 2 é dividida em 4 partes iguais
+int LatencyHistogram::bucket_index(std::uint64_t value) {
+    if (value < HISTOGRAM_SUB_BUCKETS) return static_cast<int>(value);
+    int msb = 63 - std::countl_zero(value);
+    int sub = static_cast<int>((value >> (msb - 2)) & (HISTOGRAM_SUB_BUCKETS - 1));
+    return HISTOGRAM_SUB_BUCKETS * (msb - 1) + sub;
+}
+
+/// @brief Menor valor que cai no bucket
+std::uint64_t LatencyHistogram::bucket_lower_bound(int index) {
+    if (index < HISTOGRAM_SUB_BUCKETS) return static_cast<std::uint64_t>(index);
+    int msb = index / HISTOGRAM_SUB_BUCKETS + 1;
+    std::uint64_t sub = static_cast<std::uint64_t>(index % HISTOGRAM_SUB_BUCKETS);
+    return (HISTOGRAM_SUB_BUCKETS + sub) << (msb - 2);
+}
+
+/// @brief Registra uma amostra (wait-free, pode ser chamado de qualquer thread)
+void LatencyHistogram::record(std::uint64_t value) {
+    buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    std::uint64_t current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::get_count() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::get_sum() const {
+    return sum.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::get_max() const {
+    return max.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::get_bucket(int index) const {
+    return buckets[index].load(std::memory_order_relaxed);
+}
+
+/// @brief Percentil aproximado (limite inferior do bucket que o contém)
+/// @param p Percentil em [0, 100]
+std::uint64_t LatencyHistogram::percentile(double p) const {
+    std::uint64_t total = 0;
+    for (const auto& b : buckets) total += b.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+
+    std::uint64_t rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(total));
+    if (rank >= total) rank = total - 1;
+    std::uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen > rank) return bucket_lower_bound(i);
+    }
+    return get_max();
+}
+
+const char* metric_name(MetricId id) {
+    return METRIC_NAMES[id];
+}
+
+LatencyHistogram& metric(MetricId id) {
+    return METRICS[id];
+}
+
+/// @brief Grava todos os histogramas em JSON. Os buckets vazios são omitidos;
+/// cada bucket é [limite inferior, limite superior exclusivo, contagem]
+/// @param path Arquivo de destino (sobrescrito)
+/// @return false se o arquivo não pôde ser criado
+bool dump_metrics(const char* path) {
+    std::FILE* file = std::fopen(path, "w");
+    if (!file) return false;
+
+    std::fprintf(file, "{\n  \"metrics_enabled\": %s,\n  \"metrics\": [\n", TETRIS_METRICS ? "true" : "false");
+    for (int id = 0; id < METRIC_COUNT; ++id) {
+        const LatencyHistogram& h = METRICS[id];
+        std::fprintf(file,
+                     "    {\"name\": \"%s\", \"count\": %llu, \"sum\": %llu, \"max\": %llu, "
+                     "\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu,\n     \"buckets\": [",
+                     METRIC_NAMES[id], static_cast<unsigned long long>(h.get_count()),
+                     static_cast<unsigned long long>(h.get_sum()), static_cast<unsigned long long>(h.get_max()),
+                     static_cast<unsigned long long>(h.percentile(50)), static_cast<unsigned long long>(h.percentile(90)),
+                     static_cast<unsigned long long>(h.percentile(99)), static_cast<unsigned long long>(h.percentile(99.9)));
+        bool first = true;
+        for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+            std::uint64_t n = h.get_bucket(i);
+            if (n == 0) continue;
+            std::uint64_t upper = (i + 1 < HISTOGRAM_BUCKETS) ? LatencyHistogram::bucket_lower_bound(i + 1) : UINT64_MAX;
+            std::fprintf(file, "%s[%llu, %llu, %llu]", first ? "" : ", ",
+                         static_cast<unsigned long long>(LatencyHistogram::bucket_lower_bound(i)),
+                         static_cast<unsigned long long>(upper), static_cast<unsigned long long>(n));
+            first = false;
+        }
+        std::fprintf(file, "]}%s\n", id + 1 < METRIC_COUNT ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
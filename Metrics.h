@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#ifndef TETRIS_METRICS
+#define TETRIS_METRICS 0
+#endif
+
+// Instrumentação de latência e contenção.
+// Cada métrica é um histograma lock-free de durações em ns: buckets logarítmicos
+// com 4 subdivisões por potência de 2 (erro relativo de no máximo 25%), contados
+// com fetch_add relaxado. Qualquer thread pode registrar sem travar.
+//
+// Com TETRIS_METRICS desligado (cmake -DTETRIS_METRICS=OFF), as macros abaixo
+// não geram código algum, nem mesmo as leituras do relógio. Continua só o que
+// o jogo precisa: o instante de leitura de cada tecla, que define o tick dela.
+
+enum MetricId {
+    METRIC_INPUT_LATENCY,  // Leitura da tecla (input_loop) -> aplicação (player_step)
+    METRIC_GRAVITY_JITTER, // Atraso do tick da gravidade em relação ao prazo
+    METRIC_FRAME_TIME,     // Trabalho de um quadro do render_loop (sem o sleep)
+    METRIC_COUNT
+};
+
+const int HISTOGRAM_SUB_BUCKETS = 4;
+const int HISTOGRAM_BUCKETS = 4 * 62 + HISTOGRAM_SUB_BUCKETS; // Cobre todo o intervalo de uint64
+
+class LatencyHistogram {
+public:
+    void record(std::uint64_t value);
+    void reset();
+
+    std::uint64_t get_count() const;
+    std::uint64_t get_sum() const;
+    std::uint64_t get_max() const;
+    std::uint64_t get_bucket(int index) const;
+    std::uint64_t percentile(double p) const;
+
+    static int bucket_index(std::uint64_t value);
+    static std::uint64_t bucket_lower_bound(int index);
+
+private:
+    std::atomic<std::uint64_t> buckets[HISTOGRAM_BUCKETS] = {};
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> max{0};
+};
+
+const char* metric_name(MetricId id);
+LatencyHistogram& metric(MetricId id);
+bool dump_metrics(const char* path);
+
+// Relógio usado pelas medições (steady_clock, em ns)
+long long metrics_now_ns();
+
+#if TETRIS_METRICS
+#define METRIC_RECORD(id, ns) metric(id).record(static_cast<std::uint64_t>((ns) > 0 ? (ns) : 0))
+#define METRIC_TIMER_START(name) const long long name = metrics_now_ns()
+#define METRIC_TIMER_STOP(id, name) METRIC_RECORD(id, metrics_now_ns() - (name))
+#else
+#define METRIC_RECORD(id, ns) ((void)0)
+#define METRIC_TIMER_START(name) ((void)0)
+#define METRIC_TIMER_STOP(id, name) ((void)0)
+#endif
@@ -0,0 +1,323 @@
+#include "Perft.h"
+#include "Pieces.h"
+#include <cstring>
+
+// Rotações com as mesmas células a menos de um deslocamento (O em todas, I, S e Z
+// em r e r+2): a posição (r, x, y) equivale a (rotation, x + dx, y + dy)
+struct CanonicalState {
+    int rotation;
+    int dx, dy;
+};
+
+static constexpr bool same_cells(const PieceMask& a, const PieceMask& b, int dx, int dy) {
+    // As células de cada máscara estão em ordem de varredura, então conjuntos
+    // iguais a menos de um deslocamento aparecem na mesma ordem
+    for (int i = 0; i < 4; ++i) {
+        if (a.cells[i].x - b.cells[i].x != dx || a.cells[i].y - b.cells[i].y != dy) return false;
+    }
+    return true;
+}
+
+struct CanonicalTable {
+    CanonicalState states[7][4];
+};
+
+static constexpr CanonicalTable make_canonical_table() {
+    CanonicalTable t{};
+    for (int p = 0; p < 7; ++p) {
+        for (int r = 0; r < 4; ++r) {
+            t.states[p][r] = {r, 0, 0};
+            const PieceMask& a = PIECES.masks[p][r];
+            for (int r2 = 0; r2 < r; ++r2) {
+                const PieceMask& b = PIECES.masks[p][r2];
+                int dx = a.cells[0].x - b.cells[0].x;
+                int dy = a.cells[0].y - b.cells[0].y;
+                if (same_cells(a, b, dx, dy)) {
+                    t.states[p][r] = {r2, dx, dy};
+                    break;
+                }
+            }
+        }
+    }
+    return t;
+}
+
+static constexpr CanonicalTable CANONICAL = make_canonical_table();
+
+static_assert(CANONICAL.states[PIECE_O][3].rotation == 0, "O tem uma única forma");
+static_assert(CANONICAL.states[PIECE_I][2].rotation == 0 && CANONICAL.states[PIECE_I][2].dy == 1, "I deitada uma linha abaixo");
+static_assert(CANONICAL.states[2][2].rotation == 2, "T não tem simetria");
+
+// Chaves Zobrist: uma por célula do tabuleiro, uma por (posição na fila, peça)
+// e uma por profundidade restante, geradas com splitmix64 em tempo de compilação
+struct ZobristKeys {
+    std::uint64_t cells[BOARD_HEIGHT][BOARD_WIDTH];
+    std::uint64_t queue[MAX_PERFT_DEPTH][7];
+    std::uint64_t depth[MAX_PERFT_DEPTH + 1];
+};
+
+static constexpr std::uint64_t splitmix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static constexpr ZobristKeys make_zobrist_keys() {
+    ZobristKeys k{};
+    std::uint64_t state = 0x7E7215ull;
+    for (auto& row : k.cells) {
+        for (std::uint64_t& key : row) key = splitmix64(state);
+    }
+    for (auto& slot : k.queue) {
+        for (std::uint64_t& key : slot) key = splitmix64(state);
+    }
+    for (std::uint64_t& key : k.depth) key = splitmix64(state);
+    return k;
+}
+
+static constexpr ZobristKeys ZOBRIST = make_zobrist_keys();
+
+// Nós com pelo menos esta profundidade restante espalham os filhos em tarefas do pool
+static const int PARALLEL_DEPTH = 3;
+
+static int state_index(int rotation, int x, int y) {
+    return (rotation * PLACEMENT_ROWS + (y - PLACEMENT_Y_MIN)) * PLACEMENT_COLS + (x - PLACEMENT_X_MIN);
+}
+
+static bool in_range(int x, int y) {
+    return x >= PLACEMENT_X_MIN && x < BOARD_WIDTH && y >= PLACEMENT_Y_MIN && y < BOARD_HEIGHT;
+}
+
+PlacementEnumerator::PlacementEnumerator() : piece_type(0), start_state(-1), epoch(0) {
+    std::memset(seen, 0, sizeof(seen));
+    std::memset(final_seen, 0, sizeof(final_seen));
+}
+
+/// @brief Enumera as posições finais distintas alcançáveis pela peça atual
+/// @param board Tabuleiro com a peça atual onde a busca começa (não é modificado)
+/// @param out Recebe as posições (espaço para MAX_PIECE_STATES)
+/// @return Número de posições (0 se o jogo acabou)
+int PlacementEnumerator::enumerate(const Board& board, PiecePlacement* out) {
+    start_state = -1;
+    if (board.is_game_over()) return 0;
+    scratch = board;
+    piece_type = board.get_piece_type();
+    if (++epoch == 0) {
+        std::memset(seen, 0, sizeof(seen));
+        std::memset(final_seen, 0, sizeof(final_seen));
+        epoch = 1;
+    }
+
+    int head = 0, tail = 0;
+    auto visit = [&](int from, Command move, int rotation, int x, int y) {
+        if (!in_range(x, y)) return;
+        int s = state_index(rotation, x, y);
+        if (seen[s] == epoch) return;
+        seen[s] = epoch;
+        parent[s] = static_cast<std::int16_t>(from);
+        parent_move[s] = static_cast<std::uint8_t>(move);
+        frontier[tail++] = static_cast<std::int16_t>(s);
+    };
+
+    visit(-1, CMD_NONE, board.get_piece_rotation(), board.get_piece_x(), board.get_piece_y());
+    if (tail == 0) return 0;
+    start_state = frontier[0];
+
+    int count = 0;
+    while (head < tail) {
+        int s = frontier[head++];
+        int x = s % PLACEMENT_COLS + PLACEMENT_X_MIN;
+        int y = (s / PLACEMENT_COLS) % PLACEMENT_ROWS + PLACEMENT_Y_MIN;
+        int rotation = s / (PLACEMENT_COLS * PLACEMENT_ROWS);
+
+        if (scratch.check_collision(x, y + 1, rotation)) {
+            // Apoiada: é uma posição final, a menos que uma rotação equivalente já tenha aparecido
+            const CanonicalState& c = CANONICAL.states[piece_type][rotation];
+            int canonical = in_range(x + c.dx, y + c.dy) ? state_index(c.rotation, x + c.dx, y + c.dy) : s;
+            if (final_seen[canonical] != epoch) {
+                final_seen[canonical] = epoch;
+                out[count++] = {static_cast<std::int8_t>(rotation), static_cast<std::int8_t>(x), static_cast<std::int8_t>(y)};
+            }
+        } else {
+            visit(s, CMD_DOWN, rotation, x, y + 1);
+        }
+        if (!scratch.check_collision(x - 1, y, rotation)) visit(s, CMD_LEFT, rotation, x - 1, y);
+        if (!scratch.check_collision(x + 1, y, rotation)) visit(s, CMD_RIGHT, rotation, x + 1, y);
+
+        scratch.set_piece_state(piece_type, rotation, x, y);
+        if (scratch.rotate_piece()) {
+            visit(s, CMD_ROTATE, scratch.get_piece_rotation(), scratch.get_piece_x(), scratch.get_piece_y());
+        }
+    }
+    return count;
+}
+
+/// @brief Caminho mais curto até uma posição da última enumeração
+/// @param placement Posição devolvida pelo último enumerate()
+/// @param commands Recebe os comandos, terminando com o CMD_DOWN que fixa a peça
+/// @return false se a posição não foi alcançada
+bool PlacementEnumerator::commands_to(const PiecePlacement& placement, std::vector<Command>& commands) const {
+    commands.clear();
+    if (start_state < 0 || !in_range(placement.x, placement.y)) return false;
+    int s = state_index(placement.rotation, placement.x, placement.y);
+    if (seen[s] != epoch) return false;
+
+    commands.push_back(CMD_DOWN);
+    for (; s != start_state; s = parent[s]) {
+        commands.push_back(static_cast<Command>(parent_move[s]));
+    }
+    for (std::size_t i = 0, j = commands.size() - 1; i < j; ++i, --j) {
+        Command tmp = commands[i];
+        commands[i] = commands[j];
+        commands[j] = tmp;
+    }
+    return true;
+}
+
+Perft::Perft(ThreadPool& pool, int table_bits)
+    : pool(pool), table(table_bits), queue(nullptr), queue_keys{}, nodes(0), probes(0), hits(0) {}
+
+/// @brief Chave Zobrist das células ocupadas de um tabuleiro
+std::uint64_t Perft::board_hash(const Board& board) {
+    std::uint64_t hash = 0;
+    for (int y = 0; y < BOARD_HEIGHT; ++y) {
+        unsigned mask = board.get_row_mask(y);
+        while (mask != 0) {
+            hash ^= ZOBRIST.cells[y][__builtin_ctz(mask)];
+            mask &= mask - 1;
+        }
+    }
+    return hash;
+}
+
+/// @brief Chave das células que uma peça ocupa ao ser fixada (as acima do topo se perdem)
+static std::uint64_t piece_hash(int piece_type, const PiecePlacement& placement) {
+    std::uint64_t hash = 0;
+    for (const PieceCell& cell : PIECES.masks[piece_type][placement.rotation].cells) {
+        int y = placement.y + cell.y;
+        if (y >= 0 && y < BOARD_HEIGHT) hash ^= ZOBRIST.cells[y][placement.x + cell.x];
+    }
+    return hash;
+}
+
+/// @brief Conta as sequências de posições finais de `depth` peças
+/// @param board Tabuleiro com a peça atual (a primeira da sequência)
+/// @param queue Peças seguintes, na ordem (precisa de depth - 1)
+/// @param depth Número de peças colocadas (até MAX_PERFT_DEPTH)
+/// @return Número de sequências (1 para depth = 0)
+std::uint64_t Perft::count(const Board& board, const std::vector<int>& queue, int depth) {
+    nodes = 0;
+    probes = 0;
+    hits = 0;
+    if (depth <= 0) return 1;
+    if (depth > MAX_PERFT_DEPTH) depth = MAX_PERFT_DEPTH;
+    if (depth > static_cast<int>(queue.size()) + 1) depth = static_cast<int>(queue.size()) + 1;
+    if (board.is_game_over()) return 0;
+
+    // O que resta da busca a partir do nó `index` depende só das linhas do
+    // tabuleiro e das peças queue[index - 1 ...]: a chave desse nó é a do
+    // tabuleiro combinada com esta
+    this->queue = queue.data();
+    for (int index = 1; index < depth; ++index) {
+        int depth_left = depth - index;
+        std::uint64_t key = ZOBRIST.depth[depth_left];
+        for (int k = 0; k < depth_left; ++k) key ^= ZOBRIST.queue[k][queue[index - 1 + k]];
+        queue_keys[index] = key;
+    }
+
+    PlacementEnumerator enumerator;
+    Counters counters;
+    std::uint64_t total = count_node(board, board_hash(board), 0, depth, enumerator, counters);
+    add_counters(counters);
+    return total;
+}
+
+/// @brief Conta as sequências a partir de um nó
+/// @param board Tabuleiro com a peça atual já posicionada
+/// @param hash Chave Zobrist das linhas do tabuleiro
+/// @param index Peças já colocadas desde a raiz (a próxima a nascer é queue[index])
+/// @param depth_left Peças que faltam colocar, incluindo a atual
+/// @param enumerator Rascunho da enumeração desta thread
+/// @param counters Estatísticas desta thread
+std::uint64_t Perft::count_node(const Board& board, std::uint64_t hash, int index, int depth_left,
+                                PlacementEnumerator& enumerator, Counters& counters) {
+    // A raiz não entra na tabela: a peça dela pode não estar na posição de spawn
+    std::uint64_t key = 0;
+    if (index > 0) {
+        key = hash ^ queue_keys[index];
+        if (key == 0) key = 1;
+        counters.probes++;
+        std::uint64_t cached;
+        if (table.probe(key, cached)) {
+            counters.hits++;
+            return cached;
+        }
+    }
+
+    PiecePlacement placements[MAX_PIECE_STATES];
+    int n = enumerator.enumerate(board, placements);
+    counters.nodes++;
+
+    std::uint64_t total = 0;
+    if (depth_left <= 1) {
+        // Último nível: as posições finais já são as folhas
+        total = static_cast<std::uint64_t>(n);
+    } else {
+        const int piece_type = board.get_piece_type();
+        const int next_piece = queue[index];
+        auto count_child = [&, piece_type, next_piece](const PiecePlacement& p, PlacementEnumerator& e, Counters& c) {
+            Board child = board;
+            child.set_piece_state(piece_type, p.rotation, p.x, p.y);
+            int lines = child.fix_piece_and_clear_lines();
+            std::uint64_t child_hash = (lines > 0) ? board_hash(child) : hash ^ piece_hash(piece_type, p);
+            child.spawn_piece(next_piece);
+            if (child.is_game_over()) return std::uint64_t(0);
+            return count_node(child, child_hash, index + 1, depth_left - 1, e, c);
+        };
+
+        if (depth_left >= PARALLEL_DEPTH) {
+            std::vector<std::uint64_t> values(n, 0);
+            TaskGroup group(pool);
+            for (int i = 0; i < n; ++i) {
+                group.run([&, i] {
+                    PlacementEnumerator local_enumerator;
+                    Counters local;
+                    values[i] = count_child(placements[i], local_enumerator, local);
+                    add_counters(local);
+                });
+            }
+            group.wait();
+            for (std::uint64_t v : values) total += v;
+        } else {
+            for (int i = 0; i < n; ++i) total += count_child(placements[i], enumerator, counters);
+        }
+    }
+
+    if (index > 0) table.store(key, total);
+    return total;
+}
+
+void Perft::add_counters(const Counters& counters) {
+    nodes.fetch_add(counters.nodes, std::memory_order_relaxed);
+    probes.fetch_add(counters.probes, std::memory_order_relaxed);
+    hits.fetch_add(counters.hits, std::memory_order_relaxed);
+}
+
+/// @brief Esvazia a tabela de transposição (as chaves já incluem a fila, então
+/// só é preciso para medir uma busca do zero)
+void Perft::clear_table() {
+    table.clear();
+}
+
+std::uint64_t Perft::get_nodes() const {
+    return nodes.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Perft::get_probes() const {
+    return probes.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Perft::get_hits() const {
+    return hits.load(std::memory_order_relaxed);
+}
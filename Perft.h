@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Player.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Faixa de posições (canto superior esquerdo da matriz 4x4) que a enumeração
+// considera: à esquerda, a coluna local 3 ainda cabe na coluna 0; acima, a peça
+// pode estar inteira fora do tabuleiro (kicks para cima perto do topo)
+const int PLACEMENT_X_MIN = -3;
+const int PLACEMENT_Y_MIN = -4;
+const int PLACEMENT_COLS = BOARD_WIDTH - PLACEMENT_X_MIN;
+const int PLACEMENT_ROWS = BOARD_HEIGHT - PLACEMENT_Y_MIN;
+const int MAX_PIECE_STATES = 4 * PLACEMENT_COLS * PLACEMENT_ROWS;
+
+// Maior profundidade aceita por Perft::count
+const int MAX_PERFT_DEPTH = 16;
+
+// Posição final de uma peça: apoiada, pronta para ser fixada por CMD_DOWN
+struct PiecePlacement {
+    std::int8_t rotation;
+    std::int8_t x;
+    std::int8_t y;
+};
+
+// Enumera todas as posições finais distintas que a peça atual alcança a partir
+// de onde está, por busca em largura sobre (rotação, x, y) com os mesmos
+// movimentos do jogo: esquerda, direita, descer (soft drop) e girar com wall
+// kicks. Translações usam Board::check_collision e rotações Board::rotate_piece,
+// então encaixes por baixo de saliências (tucks) e giros (spins) aparecem
+// exatamente como no jogo. Supõe que dá tempo de agir entre duas quedas da
+// gravidade. Posições com as mesmas células (rotações simétricas de O, I, S e Z)
+// contam uma vez só.
+class PlacementEnumerator {
+public:
+    PlacementEnumerator();
+
+    int enumerate(const Board& board, PiecePlacement* out);
+    bool commands_to(const PiecePlacement& placement, std::vector<Command>& commands) const;
+
+private:
+    Board scratch; // Cópia do tabuleiro usada por rotate_piece
+    int piece_type;
+    int start_state;
+
+    // Marcas por época: o estado s foi visitado nesta enumeração se seen[s] == epoch
+    std::uint32_t epoch;
+    std::uint32_t seen[MAX_PIECE_STATES];
+    std::uint32_t final_seen[MAX_PIECE_STATES];
+    std::int16_t parent[MAX_PIECE_STATES];
+    std::uint8_t parent_move[MAX_PIECE_STATES];
+    std::int16_t frontier[MAX_PIECE_STATES];
+};
+
+// "Perft" do Tetris: conta as sequências de posições finais de D peças a partir
+// de um tabuleiro (a peça atual e depois as da fila), fixando cada peça com
+// Board::fix_piece_and_clear_lines. Sequências em que uma peça não consegue
+// nascer param ali e não contam. Tabuleiros repetidos (as mesmas linhas com a
+// mesma fila pela frente) são resolvidos uma vez só: a chave Zobrist das
+// células ocupadas, atualizada a cada peça fixada, indexa uma tabela de
+// transposição lock-free dividida entre os workers do ThreadPool.
+class Perft {
+public:
+    Perft(ThreadPool& pool, int table_bits = 20);
+
+    std::uint64_t count(const Board& board, const std::vector<int>& queue, int depth);
+    void clear_table();
+
+    // Estatísticas do último count()
+    std::uint64_t get_nodes() const;  // Tabuleiros enumerados
+    std::uint64_t get_probes() const;
+    std::uint64_t get_hits() const;
+
+    static std::uint64_t board_hash(const Board& board);
+
+private:
+    struct Counters {
+        std::uint64_t nodes = 0;
+        std::uint64_t probes = 0;
+        std::uint64_t hits = 0;
+    };
+
+    ThreadPool& pool;
+    TranspositionTable table;
+    const int* queue;
+    std::uint64_t queue_keys[MAX_PERFT_DEPTH + 1];
+    std::atomic<std::uint64_t> nodes, probes, hits;
+
+    std::uint64_t count_node(const Board& board, std::uint64_t hash, int index, int depth_left,
+                             PlacementEnumerator& enumerator, Counters& counters);
+    void add_counters(const Counters& counters);
+};
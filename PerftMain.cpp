@@ -0,0 +1,217 @@
+#include "Bot.h"
+#include "Perft.h"
+#include "Pieces.h"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <vector>
+
+// Contagem exaustiva de posições ("perft"): quantas sequências de posições
+// finais existem para as próximas D peças de um tabuleiro.
+//
+// Uso: tetris_perft [--seed S] [--depth D] [--pieces N] [--threads N]
+//                    [--table-bits B] [--verify N]
+//
+// O tabuleiro é reproduzível: a seed define as peças e --pieces peças são
+// colocadas antes pelo bot de profundidade 1. A fila é a do próprio 7-bag do
+// tabuleiro. --verify N confere a enumeração em N tabuleiros aleatórios contra
+// uma busca de referência feita só com Player::apply_command e contra as
+// posições que o bot considera; uma divergência termina com código 4.
+
+using Rows = std::array<std::uint16_t, BOARD_HEIGHT>;
+
+static Rows rows_of(const Board& board) {
+    Rows rows;
+    for (int y = 0; y < BOARD_HEIGHT; ++y) rows[y] = board.get_row_mask(y);
+    return rows;
+}
+
+/// @brief Confere a enumeração da peça atual de um jogador
+/// @return false se alguma posição diverge da referência
+static bool verify_position(const Player& player, int index) {
+    static const Command MOVES[] = {CMD_LEFT, CMD_RIGHT, CMD_ROTATE, CMD_DOWN};
+
+    // Referência: busca em largura sobre cópias do jogador, só com os comandos do
+    // jogo; um CMD_DOWN que fixa a peça dá um tabuleiro final
+    std::set<Rows> reference;
+    std::set<std::array<int, 3>> visited;
+    std::vector<Player> frontier{player};
+    const Board& start = player.get_board();
+    visited.insert({start.get_piece_rotation(), start.get_piece_x(), start.get_piece_y()});
+    for (std::size_t head = 0; head < frontier.size(); ++head) {
+        for (Command cmd : MOVES) {
+            Player next = frontier[head];
+            if (next.apply_command(cmd, 0).piece_fixed) {
+                reference.insert(rows_of(next.get_board()));
+                continue;
+            }
+            const Board& b = next.get_board();
+            if (b.get_piece_y() < PLACEMENT_Y_MIN) continue;
+            if (visited.insert({b.get_piece_rotation(), b.get_piece_x(), b.get_piece_y()}).second) {
+                frontier.push_back(next);
+            }
+        }
+    }
+
+    // Enumeração: cada posição, seguida pelo caminho que ela devolve, tem de
+    // fixar a peça exatamente ali, e nenhuma pode repetir as células de outra
+    PlacementEnumerator enumerator;
+    static PiecePlacement placements[MAX_PIECE_STATES];
+    int n = enumerator.enumerate(start, placements);
+    std::set<Rows> found;
+    std::set<std::array<int, 8>> cell_sets;
+    std::vector<Command> commands;
+    for (int i = 0; i < n; ++i) {
+        const PiecePlacement& p = placements[i];
+        if (!enumerator.commands_to(p, commands)) {
+            std::fprintf(stderr, "tabuleiro %d: posição %d sem caminho\n", index, i);
+            return false;
+        }
+        Player replay = player;
+        StepResult result;
+        for (std::size_t c = 0; c + 1 < commands.size(); ++c) replay.apply_command(commands[c], 0);
+        const Board& b = replay.get_board();
+        if (b.get_piece_rotation() != p.rotation || b.get_piece_x() != p.x || b.get_piece_y() != p.y) {
+            std::fprintf(stderr, "tabuleiro %d: caminho da posição %d termina fora dela\n", index, i);
+            return false;
+        }
+        result = replay.apply_command(commands.back(), 0);
+        if (!result.piece_fixed) {
+            std::fprintf(stderr, "tabuleiro %d: posição %d não está apoiada\n", index, i);
+            return false;
+        }
+        found.insert(rows_of(replay.get_board()));
+
+        std::array<int, 8> cells;
+        const PieceMask& m = PIECES.masks[start.get_piece_type()][p.rotation];
+        for (int c = 0; c < 4; ++c) {
+            cells[2 * c] = p.x + m.cells[c].x;
+            cells[2 * c + 1] = p.y + m.cells[c].y;
+        }
+        if (!cell_sets.insert(cells).second) {
+            std::fprintf(stderr, "tabuleiro %d: posição %d repetida\n", index, i);
+            return false;
+        }
+    }
+    if (found != reference) {
+        std::fprintf(stderr, "tabuleiro %d: %zu tabuleiros finais, referência tem %zu\n", index, found.size(),
+                     reference.size());
+        return false;
+    }
+
+    // As posições do bot (girar no spawn, andar e hard drop) são um subconjunto
+    for (int rotation = 0; rotation < 4; ++rotation) {
+        for (int x = -2; x < BOARD_WIDTH; ++x) {
+            Board b = start;
+            for (int r = 0; r < rotation; ++r) b.rotate_piece();
+            if (b.get_piece_rotation() != rotation) continue;
+            int dx = (x > b.get_piece_x()) ? 1 : -1;
+            bool reachable = true;
+            while (reachable && b.get_piece_x() != x) reachable = b.move_piece(dx, 0);
+            if (!reachable) continue;
+            b.hard_drop();
+            b.fix_piece_and_clear_lines();
+            if (found.count(rows_of(b)) == 0) {
+                std::fprintf(stderr, "tabuleiro %d: posição do bot (r%d, x%d) não enumerada\n", index, rotation, x);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Confere a enumeração em tabuleiros gerados por comandos aleatórios
+/// (pilhas irregulares, com saliências, e peças no meio da queda)
+static bool verify(std::uint32_t seed, int count) {
+    static const Command RANDOM_COMMANDS[] = {CMD_LEFT, CMD_RIGHT, CMD_ROTATE, CMD_DOWN, CMD_DOWN, CMD_HARD_DROP};
+    long placements = 0;
+    for (int v = 0; v < count; ++v) {
+        Xoshiro128 rng(seed + static_cast<std::uint32_t>(v));
+        Player player;
+        player.reset(0, seed + static_cast<std::uint32_t>(v));
+        int steps = rng.below(600);
+        for (int s = 0; s < steps; ++s) {
+            Player next = player;
+            next.apply_command(RANDOM_COMMANDS[rng.below(6)], 0);
+            if (next.is_game_over()) break;
+            player = next;
+        }
+        if (!verify_position(player, v)) return false;
+        PlacementEnumerator enumerator;
+        static PiecePlacement out[MAX_PIECE_STATES];
+        placements += enumerator.enumerate(player.get_board(), out);
+    }
+    std::printf("verificacao: OK (%d tabuleiros, %ld posicoes)\n", count, placements);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::uint32_t seed = 1;
+    int depth = 3;
+    int pieces = 0;
+    unsigned threads = 0; // 0 = um por núcleo
+    int table_bits = 22;
+    int verify_count = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Opção sem valor: %s\n", argv[i]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--seed") == 0) seed = static_cast<std::uint32_t>(std::atol(value));
+        else if (std::strcmp(argv[i - 1], "--depth") == 0) depth = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--pieces") == 0) pieces = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--threads") == 0) threads = static_cast<unsigned>(std::atol(value));
+        else if (std::strcmp(argv[i - 1], "--table-bits") == 0) table_bits = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--verify") == 0) verify_count = std::atoi(value);
+        else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", argv[i - 1]);
+            return 1;
+        }
+    }
+    if (depth > MAX_PERFT_DEPTH) depth = MAX_PERFT_DEPTH;
+    if (table_bits < 10) table_bits = 10;
+    if (table_bits > 30) table_bits = 30;
+
+    if (verify_count > 0 && !verify(seed, verify_count)) return 4;
+
+    ThreadPool pool(threads);
+    Player player;
+    player.reset(0, seed);
+    Bot bot(pool, 1);
+    for (int i = 0; i < pieces && !player.is_game_over(); ++i) {
+        Bot::execute(player, bot.choose(player.get_board()), 0);
+    }
+    const Board& board = player.get_board();
+    if (board.is_game_over()) {
+        std::fprintf(stderr, "O jogo acabou antes de colocar %d peças\n", pieces);
+        return 1;
+    }
+
+    static const char PIECE_NAMES[] = "IOTSZJL";
+    std::vector<int> queue;
+    PieceGenerator generator = board.get_piece_generator();
+    for (int i = 1; i < depth; ++i) queue.push_back(generator.next());
+    std::printf("pecas: %c", PIECE_NAMES[board.get_piece_type()]);
+    for (int piece : queue) std::printf(" %c", PIECE_NAMES[piece]);
+    std::printf(", altura agregada %d, buracos %d\n", board.get_aggregate_height(), board.get_holes());
+
+    Perft perft(pool, table_bits);
+    for (int d = 1; d <= depth; ++d) {
+        perft.clear_table();
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t leaves = perft.count(board, queue, d);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::uint64_t probes = perft.get_probes();
+        std::printf("perft(%d) = %llu  (%.3f s, %llu tabuleiros enumerados, %.0f/s, tabela: %.1f%% de %llu consultas)\n",
+                    d, static_cast<unsigned long long>(leaves), seconds,
+                    static_cast<unsigned long long>(perft.get_nodes()),
+                    seconds > 0 ? perft.get_nodes() / seconds : 0.0,
+                    probes > 0 ? 100.0 * perft.get_hits() / probes : 0.0, static_cast<unsigned long long>(probes));
+    }
+    return 0;
+}
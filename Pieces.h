@@ -0,0 +1,181 @@
+#pragma once
+
+#include "Constants.h"
+#include <cstdint>
+
+// Definição das 7 peças de Tetris (4 rotações cada).
+// Todas as outras tabelas deste arquivo são derivadas dela em tempo de compilação.
+inline constexpr int TETROMINOES[7][4][4][4] = {
+    // I
+    {{{0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0}},
+     {{0,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,1,0,0}},
+     {{0,0,0,0}, {0,0,0,0}, {1,1,1,1}, {0,0,0,0}},
+     {{0,0,1,0}, {0,0,1,0}, {0,0,1,0}, {0,0,1,0}}},
+    // O
+    {{{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
+     {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
+     {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}},
+     {{0,0,0,0}, {0,1,1,0}, {0,1,1,0}, {0,0,0,0}}},
+    // T
+    {{{0,0,0,0}, {1,1,1,0}, {0,1,0,0}, {0,0,0,0}},
+     {{0,1,0,0}, {1,1,0,0}, {0,1,0,0}, {0,0,0,0}},
+     {{0,1,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}},
+     {{0,1,0,0}, {0,1,1,0}, {0,1,0,0}, {0,0,0,0}}},
+    // S
+    {{{0,0,0,0}, {0,1,1,0}, {1,1,0,0}, {0,0,0,0}},
+     {{0,1,0,0}, {0,1,1,0}, {0,0,1,0}, {0,0,0,0}},
+     {{0,0,0,0}, {0,1,1,0}, {1,1,0,0}, {0,0,0,0}},
+     {{0,1,0,0}, {0,1,1,0}, {0,0,1,0}, {0,0,0,0}}},
+    // Z
+    {{{0,0,0,0}, {1,1,0,0}, {0,1,1,0}, {0,0,0,0}},
+     {{0,0,1,0}, {0,1,1,0}, {0,1,0,0}, {0,0,0,0}},
+     {{0,0,0,0}, {1,1,0,0}, {0,1,1,0}, {0,0,0,0}},
+     {{0,0,1,0}, {0,1,1,0}, {0,1,0,0}, {0,0,0,0}}},
+    // J
+    {{{0,0,0,0}, {1,0,0,0}, {1,1,1,0}, {0,0,0,0}},
+     {{0,1,1,0}, {0,1,0,0}, {0,1,0,0}, {0,0,0,0}},
+     {{0,0,0,0}, {1,1,1,0}, {0,0,1,0}, {0,0,0,0}},
+     {{0,1,0,0}, {0,1,0,0}, {1,1,0,0}, {0,0,0,0}}},
+    // L
+    {{{0,0,0,0}, {0,0,1,0}, {1,1,1,0}, {0,0,0,0}},
+     {{0,1,0,0}, {0,1,0,0}, {0,1,1,0}, {0,0,0,0}},
+     {{0,0,0,0}, {1,1,1,0}, {1,0,0,0}, {0,0,0,0}},
+     {{1,1,0,0}, {0,1,0,0}, {0,1,0,0}, {0,0,0,0}}}
+};
+
+const int PIECE_I = 0;
+const int PIECE_O = 1;
+
+// Célula ocupada de uma peça, em coordenadas locais da matriz 4x4
+struct PieceCell {
+    std::int8_t x, y;
+};
+
+// Dados pré-calculados de cada peça/rotação
+struct PieceMask {
+    std::uint16_t rows[4];  // Uma máscara de 4 bits por linha local (bit x = coluna local x)
+    PieceCell cells[4];     // As 4 células ocupadas
+    std::int8_t bottom[4];  // Linha local mais baixa ocupada de cada coluna local (-1 = vazia)
+    int min_x, max_x;       // Extensão das células ocupadas
+    int min_y, max_y;
+};
+
+static constexpr PieceMask make_piece_mask(int piece_type, int rotation) {
+    PieceMask m{{0, 0, 0, 0}, {}, {-1, -1, -1, -1}, 4, -1, 4, -1};
+    int count = 0;
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            if (TETROMINOES[piece_type][rotation][y][x] == 0) continue;
+            m.rows[y] |= static_cast<std::uint16_t>(1u << x);
+            m.cells[count++] = {static_cast<std::int8_t>(x), static_cast<std::int8_t>(y)};
+            m.bottom[x] = static_cast<std::int8_t>(y);
+            if (x < m.min_x) m.min_x = x;
+            if (x > m.max_x) m.max_x = x;
+            if (y < m.min_y) m.min_y = y;
+            if (y > m.max_y) m.max_y = y;
+        }
+    }
+    return m;
+}
+
+// Deslocamentos testados ao girar (x para a direita, y para baixo), em ordem
+struct KickOffset {
+    std::int8_t dx, dy;
+};
+
+const int NUM_KICKS = 5;
+
+// Tabelas de wall kick do SRS para rotação horária (do estado s para s+1, com
+// 0, R, 2, L = 0, 1, 2, 3), escritas como na especificação, com y para cima;
+// make_piece_table() inverte o y
+static constexpr KickOffset SRS_KICKS_JLSTZ[4][NUM_KICKS] = {
+    {{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}},
+    {{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}},
+    {{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}},
+    {{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}},
+};
+
+static constexpr KickOffset SRS_KICKS_I[4][NUM_KICKS] = {
+    {{0, 0}, {-2, 0}, {1, 0}, {-2, -1}, {1, 2}},
+    {{0, 0}, {-1, 0}, {2, 0}, {-1, 2}, {2, -1}},
+    {{0, 0}, {2, 0}, {-1, 0}, {2, 1}, {-1, -2}},
+    {{0, 0}, {1, 0}, {-2, 0}, {1, -2}, {-2, 1}},
+};
+
+// Estado SRS de cada rotação de TETROMINOES. J e L seguem a ordem do SRS, com
+// a rotação 0 uma linha abaixo do estado 0. O T nasce com a ponta para baixo
+// (estado 2) e o I passa por 0, L, 2, R, ou seja, gira no sentido anti-horário
+// do SRS. S e Z só têm duas formas: deitada nas linhas 1-2 (estado 2) e em pé
+// nas colunas 1-2 (estado R), então alternam entre 2 e R
+static constexpr int SRS_STATE[7][4] = {
+    {0, 3, 2, 1}, // I
+    {0, 1, 2, 3}, // O
+    {2, 3, 0, 1}, // T
+    {2, 1, 2, 1}, // S
+    {2, 1, 2, 1}, // Z
+    {0, 1, 2, 3}, // J
+    {0, 1, 2, 3}, // L
+};
+
+/// @brief Teste k do SRS para a transição entre dois estados vizinhos (y para cima).
+/// A tabela só tem as rotações horárias; a anti-horária de a para b é o inverso da horária de b para a
+static constexpr KickOffset srs_kick(int piece_type, int from, int to, int k) {
+    const KickOffset (*table)[NUM_KICKS] = (piece_type == PIECE_I) ? SRS_KICKS_I : SRS_KICKS_JLSTZ;
+    if (to == (from + 1) % 4) return table[from][k];
+    KickOffset cw = table[to][k];
+    return {static_cast<std::int8_t>(-cw.dx), static_cast<std::int8_t>(-cw.dy)};
+}
+
+struct PieceTable {
+    PieceMask masks[7][4];
+    KickOffset kicks[7][4][NUM_KICKS]; // kicks[p][r]: testes da rotação r -> r+1
+    int num_kicks[7];                  // O não tem kicks (só o teste sem deslocamento)
+    int spawn_x[7];                    // Canto superior esquerdo da peça no spawn:
+    int spawn_y[7];                    // centralizada e com a primeira linha ocupada no topo
+};
+
+static constexpr PieceTable make_piece_table() {
+    PieceTable t{};
+    for (int p = 0; p < 7; ++p) {
+        for (int r = 0; r < 4; ++r) {
+            t.masks[p][r] = make_piece_mask(p, r);
+            for (int k = 0; k < NUM_KICKS; ++k) {
+                KickOffset srs = srs_kick(p, SRS_STATE[p][r], SRS_STATE[p][(r + 1) % 4], k);
+                t.kicks[p][r][k] = {srs.dx, static_cast<std::int8_t>(-srs.dy)};
+            }
+        }
+        t.num_kicks[p] = (p == PIECE_O) ? 1 : NUM_KICKS;
+
+        const PieceMask& spawn = t.masks[p][0];
+        int width = spawn.max_x - spawn.min_x + 1;
+        t.spawn_x[p] = (BOARD_WIDTH - width) / 2 - spawn.min_x;
+        t.spawn_y[p] = -spawn.min_y;
+    }
+    return t;
+}
+
+inline constexpr PieceTable PIECES = make_piece_table();
+
+// Todas as peças têm 4 células e cabem no tabuleiro ao nascer
+static_assert(PIECES.masks[PIECE_I][0].cells[3].x == 3, "I deitada ocupa as 4 colunas");
+static_assert(PIECES.spawn_x[PIECE_O] + PIECES.masks[PIECE_O][0].min_x == BOARD_WIDTH / 2 - 1, "O centralizada");
+
+// Kicks conferidos com a especificação (y para baixo aqui): T de ponta para baixo
+// girando para a esquerda usa 2->L, e o I em pé na coluna 1 indo para a linha 2 usa L->2
+static_assert(PIECES.kicks[2][0][1].dx == 1 && PIECES.kicks[2][0][1].dy == 0, "T 2->L: (+1, 0)");
+static_assert(PIECES.kicks[2][0][3].dx == 0 && PIECES.kicks[2][0][3].dy == 2, "T 2->L: (0, -2)");
+static_assert(PIECES.kicks[PIECE_I][0][1].dx == -1 && PIECES.kicks[PIECE_I][0][3].dy == -2, "I 0->L");
+static_assert(PIECES.kicks[PIECE_I][1][1].dx == -2 && PIECES.kicks[PIECE_I][1][2].dx == 1, "I L->2");
+static_assert(PIECES.kicks[PIECE_I][1][4].dx == 1 && PIECES.kicks[PIECE_I][1][4].dy == -2, "I L->2: (+1, +2)");
+
+/// @brief As rotações r e r+2 de uma peça têm os mesmos kicks (S e Z: formas idênticas)
+static constexpr bool same_kicks(int piece_type, int a, int b) {
+    for (int k = 0; k < NUM_KICKS; ++k) {
+        if (PIECES.kicks[piece_type][a][k].dx != PIECES.kicks[piece_type][b][k].dx ||
+            PIECES.kicks[piece_type][a][k].dy != PIECES.kicks[piece_type][b][k].dy) return false;
+    }
+    return true;
+}
+static_assert(same_kicks(3, 0, 2) && same_kicks(3, 1, 3), "S: a mesma rotação chuta igual");
+static_assert(same_kicks(4, 0, 2) && same_kicks(4, 1, 3), "Z: a mesma rotação chuta igual");
+static_assert(PIECES.kicks[3][0][1].dx == -1 && PIECES.kicks[3][1][1].dx == 1, "S 2->R: (-1, 0), R->2: (+1, 0)");
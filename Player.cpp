@@ -0,0 +1,184 @@
+#include "Player.h"
+#include "Replay.h"
+
+/// @brief Pontuação ganha por limpar linhas de uma vez
+/// @param lines_cleared Número de linhas limpas pela peça
+/// @return Pontos somados ao placar
+int score_for_lines(int lines_cleared) {
+    return lines_cleared * lines_cleared * 10;
+}
+
+/// @brief Quantidade de lixo enviada ao oponente por limpar linhas de uma vez
+/// @param lines_cleared Número de linhas limpas pela peça
+/// @return Linhas de lixo enviadas
+int garbage_for_lines(int lines_cleared) {
+    return (lines_cleared >= 4) ? 3 : (lines_cleared >= 2 ? lines_cleared - 1 : 0);
+}
+
+/// @brief Seed do tabuleiro de um jogador, derivada da seed da partida
+/// @param match_seed Seed da partida
+/// @param player Índice do jogador
+std::uint32_t player_seed(std::uint32_t match_seed, int player) {
+    return match_seed ^ (static_cast<std::uint32_t>(player) * 0x9E3779B9u);
+}
+
+Player::Player(const SpeedCurve& curve)
+    : score(0), lines(0), curve(curve), gravity_ticks(curve.gravity_ticks(curve.level_for_lines(0))),
+      last_drop_tick(0), recorder(nullptr), recorder_index(0), last_keyframe_tick(0) {}
+
+/// @brief Reinicia o tabuleiro, a pontuação e o nível
+/// @param tick Tick atual, usado como referência da gravidade
+/// @param seed Semente do gerador do tabuleiro (mesma semente, mesmas peças)
+void Player::reset(long tick, std::uint32_t seed) {
+    board.seed(seed);
+    board.initialize();
+    score = 0;
+    lines = 0;
+    gravity_ticks = curve.gravity_ticks(curve.level_for_lines(0));
+    last_drop_tick = tick;
+    last_keyframe_tick = tick;
+}
+
+/// @brief Passa a gravar no replay tudo que altera este jogador
+/// @param recorder Gravador (nullptr para parar de gravar)
+/// @param index Índice do jogador no replay
+void Player::attach_recorder(ReplayRecorder* recorder, int index) {
+    this->recorder = recorder;
+    recorder_index = index;
+}
+
+/// @brief Restaura pontuação, linhas e relógio da gravidade (usado pelos keyframes de replay)
+void Player::restore(int score, int lines, long last_drop_tick) {
+    this->score = score;
+    this->lines = lines;
+    this->last_drop_tick = last_drop_tick;
+    gravity_ticks = curve.gravity_ticks(curve.level_for_lines(lines));
+}
+
+long Player::get_last_drop_tick() const {
+    return last_drop_tick;
+}
+
+const SpeedCurve& Player::get_speed_curve() const {
+    return curve;
+}
+
+/// @brief Fixa a peça, limpa linhas, spawna a próxima e calcula pontuação e lixo
+/// @return Resultado da fixação (sem lixo se o jogador perdeu)
+StepResult Player::lock_piece() {
+    StepResult result;
+    result.piece_fixed = true;
+    result.lines_cleared = board.fix_piece_and_clear_lines();
+    if (result.lines_cleared > 0) {
+        lines += result.lines_cleared;
+        gravity_ticks = curve.gravity_ticks(curve.level_for_lines(lines));
+    }
+    board.spawn_new_piece();
+    if (board.is_game_over()) {
+        return result;
+    }
+
+    score += score_for_lines(result.lines_cleared);
+    result.garbage_to_send = garbage_for_lines(result.lines_cleared);
+    if (result.garbage_to_send > 0) result.garbage_hole = board.roll_garbage_hole();
+    return result;
+}
+
+/// @brief Aplica um comando do jogador na peça atual
+/// @param cmd Comando a ser aplicado
+/// @param tick Tick atual
+/// @return Resultado da ação (a peça só é fixada por CMD_DOWN ou CMD_HARD_DROP)
+StepResult Player::apply_command(Command cmd, long tick) {
+    StepResult result;
+    if (board.is_game_over()) return result;
+    if (recorder) recorder->record_input(recorder_index, cmd, tick);
+
+    switch (cmd) {
+    case CMD_LEFT:   board.move_piece(-1, 0); break;
+    case CMD_RIGHT:  board.move_piece(1, 0); break;
+    case CMD_ROTATE: board.rotate_piece(); break;
+    case CMD_DOWN:
+        if (!board.move_piece(0, 1)) {
+            result = lock_piece();
+        }
+        last_drop_tick = tick;
+        break;
+    case CMD_HARD_DROP:
+        board.hard_drop();
+        result = lock_piece();
+        last_drop_tick = tick;
+        break;
+    default: break;
+    }
+    return result;
+}
+
+/// @brief Processa uma queda da gravidade, se ela já venceu
+/// @param tick Tick atual; a queda acontece no tick em que venceu (next_drop_tick()),
+/// então quem processa atrasado chama de novo enquanto houver quedas vencidas
+/// @return Resultado da queda (piece_fixed se a peça encostou no chão)
+StepResult Player::update_gravity(long tick) {
+    StepResult result;
+    if (board.is_game_over() || tick < next_drop_tick()) return result;
+
+    last_drop_tick = next_drop_tick();
+    if (recorder) recorder->record_gravity(recorder_index, last_drop_tick);
+    if (board.check_collision_on_drop()) {
+        result = lock_piece();
+    } else {
+        board.move_piece(0, 1);
+    }
+
+    // Keyframe periódico para o replay poder pular direto para perto de um instante
+    if (recorder && last_drop_tick - last_keyframe_tick >= REPLAY_KEYFRAME_TICKS) {
+        last_keyframe_tick = last_drop_tick;
+        recorder->record_keyframe(recorder_index, *this);
+    }
+    return result;
+}
+
+/// @brief Adiciona um lote de ataques recebidos dos oponentes
+/// @param packets Ataques na ordem de chegada; buracos -1 são sorteados aqui (e gravados)
+/// @param count Número de ataques
+/// @param tick Tick atual
+void Player::receive_garbage(GarbagePacket* packets, int count, long tick) {
+    if (count <= 0 || board.is_game_over()) return;
+    for (int i = 0; i < count; ++i) {
+        if (packets[i].hole < 0) packets[i].hole = board.roll_garbage_hole();
+        if (recorder) recorder->record_garbage(recorder_index, packets[i], tick);
+    }
+    board.add_garbage(packets, count);
+}
+
+/// @brief Tick em que a próxima queda automática deve acontecer
+long Player::next_drop_tick() const {
+    return last_drop_tick + gravity_ticks;
+}
+
+long Player::get_gravity_ticks() const {
+    return gravity_ticks;
+}
+
+int Player::get_level() const {
+    return curve.level_for_lines(lines);
+}
+
+int Player::get_lines() const {
+    return lines;
+}
+
+bool Player::is_game_over() const {
+    return board.is_game_over();
+}
+
+int Player::get_score() const {
+    return score;
+}
+
+Board& Player::get_board() {
+    return board;
+}
+
+const Board& Player::get_board() const {
+    return board;
+}
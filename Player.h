@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Board.h"
+#include "SimClock.h"
+
+class ReplayRecorder;
+
+// Comandos que um jogador pode aplicar na sua peça
+enum Command : int {
+    CMD_NONE = 0,
+    CMD_LEFT,
+    CMD_RIGHT,
+    CMD_ROTATE,
+    CMD_DOWN,
+    CMD_HARD_DROP
+};
+
+// Resultado de uma ação que pode fixar a peça atual
+struct StepResult {
+    bool piece_fixed = false;
+    int lines_cleared = 0;
+    int garbage_to_send = 0;
+    int garbage_hole = 0; // Coluna do buraco do ataque (sorteada por quem envia)
+};
+
+// Regras de um jogador: tabuleiro, pontuação, nível e gravidade.
+// Não conhece threads nem terminal; o tempo é sempre passado pelo chamador como
+// número de tick (SimClock.h), vindo do relógio real (Game) ou de um contador
+// que avança o mais rápido possível (drivers headless).
+class Player {
+public:
+    explicit Player(const SpeedCurve& curve = SpeedCurve());
+    void reset(long tick, std::uint32_t seed);
+
+    StepResult apply_command(Command cmd, long tick);
+    StepResult update_gravity(long tick);
+    void receive_garbage(GarbagePacket* packets, int count, long tick);
+
+    // Replay: tudo que altera o jogador passa a ser gravado (opcional)
+    void attach_recorder(ReplayRecorder* recorder, int index);
+    void restore(int score, int lines, long last_drop_tick);
+    long get_last_drop_tick() const;
+    const SpeedCurve& get_speed_curve() const;
+
+    long next_drop_tick() const;
+    long get_gravity_ticks() const;
+    int get_level() const;
+    int get_lines() const;
+    bool is_game_over() const;
+    int get_score() const;
+    Board& get_board();
+    const Board& get_board() const;
+
+private:
+    Board board;
+    int score;
+    int lines; // Linhas limpas na partida (definem o nível)
+    SpeedCurve curve;
+    long gravity_ticks; // Ticks entre quedas no nível atual
+    long last_drop_tick;
+
+    ReplayRecorder* recorder;
+    int recorder_index;
+    long last_keyframe_tick;
+
+    StepResult lock_piece();
+};
+
+int score_for_lines(int lines_cleared);
+int garbage_for_lines(int lines_cleared);
+std::uint32_t player_seed(std::uint32_t match_seed, int player);
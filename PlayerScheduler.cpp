@@ -0,0 +1,134 @@
+#include "PlayerScheduler.h"
+#include "CpuAffinity.h"
+#include <chrono>
+
+/// @brief Relógio do agendador (mesma base do now_ms do jogo)
+static long scheduler_now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+PlayerScheduler::PlayerScheduler(int num_players, StepFn step)
+    : step(std::move(step)), state(num_players, QUEUED), generation(num_players, 0), notified(num_players, false) {
+    // Todos os jogadores começam prontos
+    for (int i = 0; i < num_players; ++i) ready.push_back(i);
+}
+
+PlayerScheduler::~PlayerScheduler() {
+    stop();
+}
+
+/// @brief Cria os workers
+/// @param num_workers Número de threads (0 = uma por núcleo, no máximo uma por jogador)
+/// @param cpus Núcleos em que os workers são fixados, em rodízio (vazio = livres)
+void PlayerScheduler::start(unsigned num_workers, const std::vector<int>& cpus) {
+    if (num_workers == 0) num_workers = std::thread::hardware_concurrency();
+    if (num_workers == 0) num_workers = 1;
+    if (num_workers > state.size()) num_workers = static_cast<unsigned>(state.size());
+
+    for (unsigned i = 0; i < num_workers; ++i) {
+        workers.emplace_back(&PlayerScheduler::worker_loop, this);
+        if (!cpus.empty()) pin_thread(workers.back().native_handle(), cpus[i % cpus.size()]);
+    }
+}
+
+/// @brief Acorda um jogador antes do prazo (pode ser chamado de qualquer thread)
+/// @param player Índice do jogador
+void PlayerScheduler::notify(int player) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        switch (state[player]) {
+        case WAITING:
+            state[player] = QUEUED;
+            generation[player]++; // O timer pendente deixa de valer
+            ready.push_back(player);
+            break;
+        case RUNNING:
+            notified[player] = true; // Roda de novo assim que terminar
+            return;
+        default:
+            return;
+        }
+    }
+    cv.notify_one();
+}
+
+/// @brief Volta a agendar um jogador que terminou (o passo devolveu -1)
+/// @param player Índice do jogador; se ele ainda está rodando, roda de novo ao terminar
+void PlayerScheduler::resume(int player) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        switch (state[player]) {
+        case FINISHED:
+            state[player] = QUEUED;
+            ready.push_back(player);
+            break;
+        case RUNNING:
+            notified[player] = true;
+            return;
+        default:
+            return;
+        }
+    }
+    cv.notify_one();
+}
+
+/// @brief Para os workers e espera eles terminarem
+void PlayerScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (std::thread& t : workers) {
+        if (t.joinable()) t.join();
+    }
+    workers.clear();
+}
+
+void PlayerScheduler::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        int player = -1;
+        if (!ready.empty()) {
+            player = ready.front();
+            ready.pop_front();
+        } else if (!timers.empty()) {
+            Timer next = timers.top();
+            if (next.generation != generation[next.player] || state[next.player] != WAITING) {
+                timers.pop(); // Timer antigo
+                continue;
+            }
+            if (next.deadline > scheduler_now_ms()) {
+                cv.wait_until(lock, std::chrono::steady_clock::time_point(std::chrono::milliseconds(next.deadline)));
+                continue;
+            }
+            timers.pop();
+            player = next.player;
+        } else {
+            cv.wait(lock);
+            continue;
+        }
+
+        state[player] = RUNNING;
+        notified[player] = false;
+        generation[player]++;
+        lock.unlock();
+
+        long deadline = step(player);
+
+        lock.lock();
+        if (notified[player]) {
+            // Acordado durante o passo (ou resume() depois de um último passo que devolveu -1)
+            state[player] = QUEUED;
+            ready.push_back(player);
+        } else if (deadline < 0) {
+            state[player] = FINISHED;
+        } else {
+            state[player] = WAITING;
+            timers.push({deadline, generation[player], player});
+            // Outro worker pode estar dormindo até um prazo mais distante
+            cv.notify_one();
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Multiplexa os jogadores de uma partida sobre um número fixo de workers.
+// Cada jogador tem um prazo (a próxima queda da gravidade, por exemplo) e pode
+// ser acordado antes dele por notify() (input, lixo recebido, fim de jogo).
+// Um jogador nunca é processado por dois workers ao mesmo tempo, então a
+// função de passo pode alterar o estado dele sem travas extras.
+// O índice não precisa ser um jogador: o tetris_server agenda uma partida
+// inteira por índice e usa resume() para reaproveitar índices que terminaram.
+class PlayerScheduler {
+public:
+    // Processa um jogador e devolve o próximo prazo (ms do steady_clock), ou -1 para não agendar mais
+    using StepFn = std::function<long(int player)>;
+
+    PlayerScheduler(int num_players, StepFn step);
+    ~PlayerScheduler();
+
+    void start(unsigned num_workers, const std::vector<int>& cpus = {});
+    void notify(int player);
+    void resume(int player);
+    void stop();
+
+private:
+    enum SlotState : std::uint8_t { WAITING, QUEUED, RUNNING, FINISHED };
+
+    struct Timer {
+        long deadline;
+        std::uint32_t generation;
+        int player;
+        bool operator>(const Timer& other) const { return deadline > other.deadline; }
+    };
+
+    StepFn step;
+    std::vector<SlotState> state;
+    std::vector<std::uint32_t> generation; // Invalida timers antigos sem removê-los do heap
+    std::vector<bool> notified;            // notify() chegou enquanto o jogador rodava
+    std::deque<int> ready;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    void worker_loop();
+};
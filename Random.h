@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+
+// xoshiro128++: gerador pequeno (16 bytes de estado), rápido e com boa qualidade.
+// Cada tabuleiro tem o seu, então não há estado global dividido entre threads.
+class Xoshiro128 {
+public:
+    explicit Xoshiro128(std::uint32_t seed = 1) {
+        this->seed(seed);
+    }
+
+    /// @brief Reinicia o gerador; o estado é espalhado com splitmix32 (nunca fica todo zero)
+    void seed(std::uint32_t seed) {
+        for (std::uint32_t& word : s) {
+            seed += 0x9E3779B9u;
+            std::uint32_t z = seed;
+            z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+            z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+            word = z ^ (z >> 16);
+        }
+        if ((s[0] | s[1] | s[2] | s[3]) == 0) s[0] = 1;
+    }
+
+    std::uint32_t next() {
+        const std::uint32_t result = rotl(s[0] + s[3], 7) + s[0];
+        const std::uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+
+    /// @brief Inteiro em [0, n) sem o viés do operador % (método de Lemire).
+    /// A rejeição só ocorre com probabilidade < n / 2^32: para os n do jogo,
+    /// na prática a sequência é a mesma da multiplicação simples
+    int below(int n) {
+        const std::uint32_t range = static_cast<std::uint32_t>(n);
+        std::uint64_t m = static_cast<std::uint64_t>(next()) * range;
+        if (static_cast<std::uint32_t>(m) < range) {
+            const std::uint32_t threshold = -range % range; // 2^32 mod n
+            while (static_cast<std::uint32_t>(m) < threshold) {
+                m = static_cast<std::uint64_t>(next()) * range;
+            }
+        }
+        return static_cast<int>(m >> 32);
+    }
+
+    std::uint32_t s[4];
+
+private:
+    static std::uint32_t rotl(std::uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+};
+
+// Tamanho da fila de próximas peças visível (preview)
+const int PREVIEW_SIZE = 5;
+
+// Sequência de peças no sistema "7-bag": cada saco tem as 7 peças numa ordem
+// embaralhada, então nunca há secas longas de uma peça. Mantém uma fila com
+// as próximas PREVIEW_SIZE peças já sorteadas.
+class PieceGenerator {
+public:
+    explicit PieceGenerator(std::uint32_t seed = 1) {
+        this->seed(seed);
+    }
+
+    void seed(std::uint32_t seed) {
+        rng.seed(seed);
+        bag_pos = 7;
+        preview_pos = 0;
+        for (std::uint8_t& p : preview) p = draw_from_bag();
+    }
+
+    /// @brief Retira a próxima peça da fila e sorteia uma nova para o fim dela
+    int next() {
+        int piece = preview[preview_pos];
+        preview[preview_pos] = draw_from_bag();
+        preview_pos = (preview_pos + 1) % PREVIEW_SIZE;
+        return piece;
+    }
+
+    /// @brief Peça na posição i da fila (0 = a próxima a sair)
+    int peek(int i) const {
+        return preview[(preview_pos + i) % PREVIEW_SIZE];
+    }
+
+    Xoshiro128 rng;
+    std::uint8_t bag[7];
+    std::uint8_t bag_pos;
+    std::uint8_t preview[PREVIEW_SIZE];
+    std::uint8_t preview_pos;
+
+private:
+    std::uint8_t draw_from_bag() {
+        if (bag_pos >= 7) {
+            // Fisher-Yates
+            for (int i = 0; i < 7; ++i) bag[i] = static_cast<std::uint8_t>(i);
+            for (int i = 6; i > 0; --i) {
+                int j = rng.below(i + 1);
+                std::uint8_t tmp = bag[i];
+                bag[i] = bag[j];
+                bag[j] = tmp;
+            }
+            bag_pos = 0;
+        }
+        return bag[bag_pos++];
+    }
+};
@@ -0,0 +1,105 @@
+#include "Renderer.h"
+#include "Pieces.h"
+#include <cstring>
+
+/// @brief Habilita o uso de cores e cria um par de cor para cada peça do tetris (e o lixo)
+void init_piece_colors() {
+    start_color();
+    init_pair(1, COLOR_CYAN, COLOR_BLACK);
+    init_pair(2, COLOR_YELLOW, COLOR_BLACK);
+    init_pair(3, COLOR_MAGENTA, COLOR_BLACK);
+    init_pair(4, COLOR_GREEN, COLOR_BLACK);
+    init_pair(5, COLOR_RED, COLOR_BLACK);
+    init_pair(6, COLOR_BLUE, COLOR_BLACK);
+    init_pair(7, COLOR_WHITE, COLOR_BLACK);
+    init_pair(8, COLOR_WHITE, COLOR_WHITE);
+}
+
+/// @brief Escreve a fila de próximas peças de um jogador (letras I O T S Z J L)
+void print_preview(WINDOW* win, int y, int x, const BoardSnapshot& snapshot) {
+    static const char PIECE_NAMES[] = "IOTSZJL";
+    char text[2 * PREVIEW_SIZE + 1];
+    for (int i = 0; i < PREVIEW_SIZE; ++i) {
+        int piece = snapshot.next_pieces[i];
+        text[2 * i] = (piece >= 0 && piece < 7) ? PIECE_NAMES[piece] : '?';
+        text[2 * i + 1] = ' ';
+    }
+    text[2 * PREVIEW_SIZE - 1] = '\0';
+    mvwprintw(win, y, x, "Prox: %s", text);
+}
+
+BoardRenderer::BoardRenderer() {
+    invalidate();
+}
+
+/// @brief Força o próximo draw() a redesenhar a janela inteira
+void BoardRenderer::invalidate() {
+    std::memset(last_frame, 0, sizeof(last_frame));
+    last_version = 0;
+    has_frame = false;
+}
+
+/// @brief Desenha as diferenças entre o snapshot e o último quadro (sem refresh físico)
+/// @param win Janela do jogador
+/// @param snapshot Snapshot publicado pela thread do jogador
+/// @return true se algo foi escrito na janela (wnoutrefresh já chamado)
+bool BoardRenderer::draw(WINDOW* win, const BoardSnapshot& snapshot) {
+    // Nada mudou desde o último quadro
+    if (has_frame && snapshot.version == last_version) return false;
+
+    // Monta o quadro novo: grid fixo com a peça atual por cima
+    std::uint8_t frame[BOARD_HEIGHT][BOARD_WIDTH];
+    std::memcpy(frame, snapshot.cells, sizeof(frame));
+    int piece_type = snapshot.piece_type;
+    const PieceMask& mask = PIECES.masks[piece_type][snapshot.piece_rotation];
+
+    // Fantasma: onde a peça cairia com um hard drop (só nas células vazias)
+    if (!snapshot.game_over && snapshot.ghost_y > snapshot.piece_y) {
+        for (const PieceCell& cell : mask.cells) {
+            int board_x = snapshot.piece_x + cell.x;
+            int board_y = snapshot.ghost_y + cell.y;
+            if (board_y >= 0 && board_y < BOARD_HEIGHT && board_x >= 0 && board_x < BOARD_WIDTH &&
+                frame[board_y][board_x] == 0) {
+                frame[board_y][board_x] = static_cast<std::uint8_t>(GHOST_CELL + piece_type + 1);
+            }
+        }
+    }
+
+    for (const PieceCell& cell : mask.cells) {
+        int board_x = snapshot.piece_x + cell.x;
+        int board_y = snapshot.piece_y + cell.y;
+        if (board_y >= 0 && board_y < BOARD_HEIGHT && board_x >= 0 && board_x < BOARD_WIDTH) {
+            frame[board_y][board_x] = static_cast<std::uint8_t>(piece_type + 1);
+        }
+    }
+
+    if (!has_frame) {
+        werase(win);
+        box(win, 0, 0);
+    }
+
+    // Emite só as células diferentes do quadro anterior
+    for (int y = 0; y < BOARD_HEIGHT; ++y) {
+        for (int x = 0; x < BOARD_WIDTH; ++x) {
+            int color = frame[y][x];
+            if (has_frame && color == last_frame[y][x]) continue;
+            if (color >= GHOST_CELL) {
+                wattron(win, COLOR_PAIR(color - GHOST_CELL));
+                mvwprintw(win, y + 1, x * 2 + 1, "::");
+                wattroff(win, COLOR_PAIR(color - GHOST_CELL));
+            } else if (color != 0) {
+                wattron(win, COLOR_PAIR(color));
+                mvwprintw(win, y + 1, x * 2 + 1, "[]");
+                wattroff(win, COLOR_PAIR(color));
+            } else if (has_frame) {
+                mvwprintw(win, y + 1, x * 2 + 1, "  ");
+            }
+        }
+    }
+
+    std::memcpy(last_frame, frame, sizeof(last_frame));
+    last_version = snapshot.version;
+    has_frame = true;
+    wnoutrefresh(win);
+    return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Snapshot.h"
+#include <cstdint>
+#include <ncurses.h>
+
+void init_piece_colors();
+void print_preview(WINDOW* win, int y, int x, const BoardSnapshot& snapshot);
+
+// Células do fantasma no quadro: GHOST_CELL + cor da peça
+const std::uint8_t GHOST_CELL = 16;
+
+// Renderização incremental de um tabuleiro numa janela do ncurses.
+// Guarda o último quadro desenhado e só emite as células que mudaram;
+// o chamador junta todas as janelas num único doupdate().
+class BoardRenderer {
+public:
+    BoardRenderer();
+
+    bool draw(WINDOW* win, const BoardSnapshot& snapshot);
+    void invalidate();
+
+private:
+    std::uint8_t last_frame[BOARD_HEIGHT][BOARD_WIDTH]; // Cor desenhada em cada célula
+    std::uint32_t last_version;
+    bool has_frame;
+};
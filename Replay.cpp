@@ -0,0 +1,468 @@
+#include "Replay.h"
+#include <chrono>
+
+static const char REPLAY_MAGIC[4] = {'T', 'T', 'R', 'P'};
+static const std::size_t FLUSH_BYTES = 64 * 1024;
+
+// ---------------------------------------------------------------------------
+// Codificação (varint LEB128 e zigzag para números com sinal)
+// ---------------------------------------------------------------------------
+
+static void put_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+static void put_signed(std::vector<std::uint8_t>& out, std::int64_t value) {
+    put_varint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+// Leitor com checagem de limites: qualquer leitura fora do arquivo marca erro
+struct ReplayReader {
+    const std::uint8_t* pos;
+    const std::uint8_t* end;
+    bool error = false;
+
+    std::uint8_t byte() {
+        if (pos >= end) {
+            error = true;
+            return 0;
+        }
+        return *pos++;
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint8_t b = byte();
+            value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return value;
+        }
+        error = true;
+        return value;
+    }
+
+    std::int64_t signed_varint() {
+        std::uint64_t z = varint();
+        return static_cast<std::int64_t>((z >> 1) ^ (~(z & 1) + 1));
+    }
+};
+
+static void put_u32(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+static std::uint32_t read_u32(ReplayReader& in) {
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= static_cast<std::uint32_t>(in.byte()) << (8 * i);
+    return v;
+}
+
+/// @brief Codifica os geradores do tabuleiro: estados crus (são aleatórios, varint
+/// não ajudaria), o saco 7-bag e a fila de preview, duas peças por byte
+static void put_random_state(std::vector<std::uint8_t>& out, const PieceGenerator& pieces, const Xoshiro128& garbage) {
+    for (std::uint32_t word : pieces.rng.s) put_u32(out, word);
+    for (std::uint32_t word : garbage.s) put_u32(out, word);
+    for (int i = 0; i < 7; i += 2) {
+        int high = (i + 1 < 7) ? pieces.bag[i + 1] : 0;
+        out.push_back(static_cast<std::uint8_t>(pieces.bag[i] | (high << 4)));
+    }
+    for (int i = 0; i < PREVIEW_SIZE; i += 2) {
+        int high = (i + 1 < PREVIEW_SIZE) ? pieces.preview[i + 1] : 0;
+        out.push_back(static_cast<std::uint8_t>(pieces.preview[i] | (high << 4)));
+    }
+    out.push_back(static_cast<std::uint8_t>(pieces.bag_pos | (pieces.preview_pos << 4)));
+}
+
+static void read_random_state(ReplayReader& in, PieceGenerator& pieces, Xoshiro128& garbage) {
+    for (std::uint32_t& word : pieces.rng.s) word = read_u32(in);
+    for (std::uint32_t& word : garbage.s) word = read_u32(in);
+    for (int i = 0; i < 7; i += 2) {
+        std::uint8_t packed = in.byte();
+        pieces.bag[i] = packed & 0xF;
+        if (i + 1 < 7) pieces.bag[i + 1] = packed >> 4;
+    }
+    for (int i = 0; i < PREVIEW_SIZE; i += 2) {
+        std::uint8_t packed = in.byte();
+        pieces.preview[i] = packed & 0xF;
+        if (i + 1 < PREVIEW_SIZE) pieces.preview[i + 1] = packed >> 4;
+    }
+    std::uint8_t positions = in.byte();
+    pieces.bag_pos = positions & 0xF;
+    pieces.preview_pos = positions >> 4;
+}
+
+/// @brief Codifica o estado completo de um jogador (conteúdo de um keyframe)
+/// @param out Destino
+/// @param p Estado do jogador
+/// @param tick Tick do keyframe (relativo ao início)
+/// @param start_tick Início da partida no relógio do jogador
+static void encode_keyframe(std::vector<std::uint8_t>& out, const Player& p, long tick, long start_tick) {
+    const Board& b = p.get_board();
+    put_varint(out, static_cast<std::uint64_t>(p.get_score()));
+    put_varint(out, static_cast<std::uint64_t>(p.get_lines()));
+    put_signed(out, (p.get_last_drop_tick() - start_tick) - tick);
+    out.push_back(static_cast<std::uint8_t>((b.is_game_over() ? 1 : 0) | (b.get_piece_type() << 1) |
+                                            (b.get_piece_rotation() << 4)));
+    put_signed(out, b.get_piece_x());
+    put_signed(out, b.get_piece_y());
+    put_random_state(out, b.get_piece_generator(), b.get_garbage_random());
+
+    // Cada linha: máscara de ocupação e as cores das células ocupadas, duas por byte
+    for (int y = 0; y < BOARD_HEIGHT; ++y) {
+        unsigned mask = b.get_row_mask(y);
+        put_varint(out, mask);
+        int pending = -1;
+        for (int x = 0; x < BOARD_WIDTH; ++x) {
+            if ((mask & (1u << x)) == 0) continue;
+            int color = b.get_cell(x, y) & 0xF;
+            if (pending < 0) {
+                pending = color;
+            } else {
+                out.push_back(static_cast<std::uint8_t>(pending | (color << 4)));
+                pending = -1;
+            }
+        }
+        if (pending >= 0) out.push_back(static_cast<std::uint8_t>(pending));
+    }
+}
+
+/// @brief Decodifica um keyframe sobre um jogador recém-criado
+static void decode_keyframe(ReplayReader& in, Player& p, long tick) {
+    Board& b = p.get_board();
+    int score = static_cast<int>(in.varint());
+    int lines = static_cast<int>(in.varint());
+    long last_drop = tick + static_cast<long>(in.signed_varint());
+    std::uint8_t flags = in.byte();
+    int x = static_cast<int>(in.signed_varint());
+    int y = static_cast<int>(in.signed_varint());
+    PieceGenerator pieces;
+    Xoshiro128 garbage;
+    read_random_state(in, pieces, garbage);
+
+    for (int row = 0; row < BOARD_HEIGHT; ++row) {
+        unsigned mask = static_cast<unsigned>(in.varint());
+        std::uint8_t packed = 0;
+        int nibble = 0;
+        for (int col = 0; col < BOARD_WIDTH; ++col) {
+            int color = 0;
+            if (mask & (1u << col)) {
+                if (nibble == 0) packed = in.byte();
+                color = (nibble == 0) ? (packed & 0xF) : (packed >> 4);
+                nibble ^= 1;
+            }
+            b.set_cell(col, row, color);
+        }
+    }
+
+    b.set_piece_state((flags >> 1) & 0x7, (flags >> 4) & 0x3, x, y);
+    b.set_game_over((flags & 1) != 0);
+    b.set_random_state(pieces, garbage);
+    p.restore(score, lines, last_drop);
+}
+
+// ---------------------------------------------------------------------------
+// Gravação
+// ---------------------------------------------------------------------------
+
+ReplayRecorder::ReplayRecorder(const char* path, const std::vector<std::uint32_t>& seeds, const SpeedCurve& curve, long start_tick,
+                               bool wait_when_full)
+    : file(std::fopen(path, "wb")), start_tick(start_tick), wait_when_full(wait_when_full) {
+    if (!file) return;
+
+    for (std::size_t i = 0; i < seeds.size(); ++i) {
+        tracks.push_back(std::make_unique<Track>());
+    }
+
+    buffer.reserve(FLUSH_BYTES * 2);
+    buffer.insert(buffer.end(), REPLAY_MAGIC, REPLAY_MAGIC + 4);
+    buffer.push_back(REPLAY_VERSION);
+    put_varint(buffer, seeds.size());
+    put_varint(buffer, static_cast<std::uint64_t>(TICKS_PER_SECOND));
+    put_varint(buffer, static_cast<std::uint64_t>(curve.start_level));
+    put_varint(buffer, static_cast<std::uint64_t>(curve.lines_per_level));
+    for (std::uint32_t seed : seeds) put_varint(buffer, seed);
+
+    writer = std::thread(&ReplayRecorder::writer_loop, this);
+}
+
+ReplayRecorder::~ReplayRecorder() {
+    close();
+}
+
+bool ReplayRecorder::is_open() const {
+    return file != nullptr;
+}
+
+/// @brief Registros perdidos porque a fila de algum jogador encheu
+long ReplayRecorder::get_dropped_events() const {
+    return dropped_events.load(std::memory_order_relaxed);
+}
+
+/// @brief Para a thread de escrita, grava o que falta e fecha o arquivo
+void ReplayRecorder::close() {
+    if (!file) return;
+    stopping = true;
+    if (writer.joinable()) writer.join();
+    drain_all();
+    flush();
+    std::fclose(file);
+    file = nullptr;
+}
+
+/// @brief (Produtor) Enfileira um registro. Fila cheia: descarta, ou espera a
+/// thread de escrita esvaziá-la se wait_when_full
+void ReplayRecorder::push(int player, std::uint8_t type, std::int32_t value, long tick) {
+    if (!file) return;
+    Track& track = *tracks[player];
+    long relative = tick - start_tick;
+    track.last_event_tick = relative;
+    const ReplayEvent ev{relative, player, type, value};
+    while (!track.events.try_push(ev)) {
+        if (!wait_when_full) {
+            dropped_events.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void ReplayRecorder::record_input(int player, Command cmd, long tick) {
+    push(player, REPLAY_INPUT, cmd, tick);
+}
+
+void ReplayRecorder::record_gravity(int player, long tick) {
+    push(player, REPLAY_GRAVITY, 0, tick);
+}
+
+void ReplayRecorder::record_garbage(int player, const GarbagePacket& packet, long tick) {
+    push(player, REPLAY_GARBAGE, (packet.lines << 4) | (packet.hole & 0xF), tick);
+}
+
+/// @brief Grava o estado completo do jogador no tick do último registro dele
+void ReplayRecorder::record_keyframe(int player, const Player& state) {
+    if (!file) return;
+    Track& track = *tracks[player];
+    if (!track.keyframes.try_push(state)) return; // Keyframe é opcional: pode ser pulado
+    push(player, REPLAY_KEYFRAME, 0, track.last_event_tick + start_tick);
+}
+
+/// @brief Grava a pontuação final do jogador (usada para verificar a reexecução)
+void ReplayRecorder::record_end(int player, const Player& state, long tick) {
+    push(player, REPLAY_END, state.get_score(), tick);
+}
+
+void ReplayRecorder::writer_loop() {
+    auto last_flush = std::chrono::steady_clock::now();
+    while (!stopping) {
+        drain_all();
+        auto now = std::chrono::steady_clock::now();
+        if (buffer.size() >= FLUSH_BYTES || now - last_flush >= std::chrono::seconds(1)) {
+            flush();
+            last_flush = now;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+}
+
+/// @brief (Escritor) Codifica todos os registros pendentes de todos os jogadores
+void ReplayRecorder::drain_all() {
+    for (std::unique_ptr<Track>& track : tracks) {
+        track->events.drain([&](const ReplayEvent& ev) {
+            std::uint32_t player = static_cast<std::uint32_t>(ev.player);
+            std::uint32_t value = static_cast<std::uint32_t>(ev.value);
+            if (ev.type == REPLAY_END) value = 7; // Pontuação sempre vai no varint
+
+            std::uint8_t tag = static_cast<std::uint8_t>(ev.type | ((value < 7 ? value : 7) << 3) |
+                                                         ((player < 3 ? player : 3) << 6));
+            buffer.push_back(tag);
+            if (player >= 3) put_varint(buffer, player);
+            if (value >= 7) put_varint(buffer, static_cast<std::uint32_t>(ev.value));
+            put_signed(buffer, ev.tick - last_written_tick);
+            last_written_tick = ev.tick;
+
+            if (ev.type == REPLAY_KEYFRAME) {
+                Player state;
+                if (track->keyframes.try_pop(state)) encode_keyframe(buffer, state, ev.tick, start_tick);
+            }
+        });
+    }
+}
+
+void ReplayRecorder::flush() {
+    if (!buffer.empty()) {
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        std::fflush(file);
+        buffer.clear();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Reexecução
+// ---------------------------------------------------------------------------
+
+/// @brief Lê e decodifica um replay inteiro para a memória
+/// @param path Caminho do arquivo
+/// @return false se o arquivo não existe ou está corrompido
+bool ReplayPlayer::load(const char* path) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    std::vector<std::uint8_t> data;
+    std::uint8_t chunk[1 << 16];
+    std::size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    std::fclose(f);
+
+    ReplayReader in{data.data(), data.data() + data.size()};
+    for (char c : REPLAY_MAGIC) {
+        if (in.byte() != static_cast<std::uint8_t>(c)) return false;
+    }
+    if (in.byte() != REPLAY_VERSION) return false;
+
+    std::size_t num_players = static_cast<std::size_t>(in.varint());
+    ticks_per_second = static_cast<long>(in.varint());
+    curve.start_level = static_cast<int>(in.varint());
+    curve.lines_per_level = static_cast<int>(in.varint());
+    if (in.error || num_players == 0 || num_players > 4096 || ticks_per_second <= 0) return false;
+
+    tracks.assign(num_players, Track());
+    for (Track& track : tracks) {
+        track.seed = static_cast<std::uint32_t>(in.varint());
+        track.player = Player(curve);
+        track.player.reset(0, track.seed);
+    }
+
+    long time = 0;
+    event_count = 0;
+    while (in.pos < in.end && !in.error) {
+        std::uint8_t tag = in.byte();
+        ReplayEvent ev;
+        ev.type = tag & 0x7;
+        std::uint32_t value = (tag >> 3) & 0x7;
+        std::uint32_t player = tag >> 6;
+        if (player == 3) player = static_cast<std::uint32_t>(in.varint());
+        if (value == 7) value = static_cast<std::uint32_t>(in.varint());
+        time += static_cast<long>(in.signed_varint());
+        if (in.error || player >= num_players || ev.type > REPLAY_END) return false;
+
+        ev.tick = time;
+        ev.player = static_cast<std::int32_t>(player);
+        ev.value = static_cast<std::int32_t>(value);
+
+        Track& track = tracks[player];
+        track.events.push_back(ev);
+        if (ev.type == REPLAY_KEYFRAME) {
+            Keyframe kf{time, track.events.size(), Player(curve)};
+            kf.state.reset(0, track.seed);
+            decode_keyframe(in, kf.state, time);
+            track.keyframes.push_back(kf);
+        } else if (ev.type == REPLAY_END) {
+            track.has_end = true;
+            track.final_score = ev.value;
+        }
+        if (time > end_tick) end_tick = time;
+        event_count++;
+    }
+    tick = 0;
+    return !in.error;
+}
+
+int ReplayPlayer::get_num_players() const {
+    return static_cast<int>(tracks.size());
+}
+
+long ReplayPlayer::get_ticks_per_second() const {
+    return ticks_per_second;
+}
+
+long ReplayPlayer::get_tick() const {
+    return tick;
+}
+
+long ReplayPlayer::get_end_tick() const {
+    return end_tick;
+}
+
+long long ReplayPlayer::get_event_count() const {
+    return event_count;
+}
+
+const Player& ReplayPlayer::get_player(int player) const {
+    return tracks[player].player;
+}
+
+/// @brief Aplica um registro no jogador da trilha
+void ReplayPlayer::apply(Track& track, const ReplayEvent& ev) {
+    Player& p = track.player;
+    switch (ev.type) {
+    case REPLAY_INPUT:
+        p.apply_command(static_cast<Command>(ev.value), ev.tick);
+        break;
+    case REPLAY_GRAVITY:
+        // A gravidade gravada tem que disparar exatamente no mesmo tick
+        p.update_gravity(ev.tick);
+        if (p.get_last_drop_tick() != ev.tick) gravity_mismatches++;
+        break;
+    case REPLAY_GARBAGE: {
+        GarbagePacket packet{ev.value >> 4, ev.value & 0xF};
+        p.receive_garbage(&packet, 1, ev.tick);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/// @brief Avança a reexecução até um tick
+/// @param tick Tick alvo (relativo ao início)
+/// @return Número de registros aplicados
+long long ReplayPlayer::run_until(long tick) {
+    long long applied = 0;
+    for (Track& track : tracks) {
+        while (track.cursor < track.events.size() && track.events[track.cursor].tick <= tick) {
+            apply(track, track.events[track.cursor++]);
+            applied++;
+        }
+    }
+    if (tick > this->tick || applied > 0) this->tick = tick;
+    return applied;
+}
+
+/// @brief Pula para um tick: restaura cada jogador do último keyframe antes dele
+/// e reexecuta só os registros a partir dali
+/// @param tick Tick alvo (pode ser antes do atual)
+void ReplayPlayer::seek(long tick) {
+    for (Track& track : tracks) {
+        const Keyframe* best = nullptr;
+        for (const Keyframe& kf : track.keyframes) {
+            if (kf.tick > tick) break;
+            best = &kf;
+        }
+        if (best) {
+            track.player = best->state;
+            track.cursor = best->next_event;
+        } else {
+            track.player = Player(curve);
+            track.player.reset(0, track.seed);
+            track.cursor = 0;
+        }
+    }
+    this->tick = tick;
+    run_until(tick);
+}
+
+/// @brief Compara o resultado da reexecução com o que foi gravado
+/// @param mismatches Saída: número de divergências encontradas
+/// @return true se a reexecução reproduziu a partida exatamente
+bool ReplayPlayer::verify(int& mismatches) const {
+    mismatches = gravity_mismatches;
+    for (const Track& track : tracks) {
+        if (track.has_end && track.player.get_score() != track.final_score) mismatches++;
+    }
+    return mismatches == 0;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Player.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Formato do replay (binário, compacto):
+//   cabeçalho: "TTRP", versão, número de jogadores, ticks por segundo, curva de velocidade
+//   (nível inicial e linhas por nível) e a seed de cada jogador
+//   registros: um byte de tag (tipo em 3 bits, valor em 3 bits, jogador em 2 bits; o valor
+//   ou jogador máximo indica que o número real vem num varint), o delta em ticks em
+//   relação ao registro anterior (varint zigzag) e o conteúdo do keyframe, se houver.
+// Comandos ocupam 2 bytes na maioria dos casos.
+// 2: 7-bag com preview; 3: spawn no topo e wall kicks; 4: lixo em pacotes; 5: tempo em ticks e níveis
+const std::uint8_t REPLAY_VERSION = 5;
+const long REPLAY_KEYFRAME_TICKS = 5 * TICKS_PER_SECOND; // Intervalo entre keyframes de cada jogador
+
+enum ReplayEventType : std::uint8_t {
+    REPLAY_INPUT = 0,   // value = Command
+    REPLAY_GRAVITY,     // Queda automática da peça
+    REPLAY_GARBAGE,     // value = linhas de lixo recebidas << 4 | coluna do buraco
+    REPLAY_KEYFRAME,    // Estado completo do jogador depois dos registros anteriores
+    REPLAY_END          // value = pontuação final
+};
+
+struct ReplayEvent {
+    long tick; // Relativo ao início da partida
+    std::int32_t player;
+    std::uint8_t type;
+    std::int32_t value;
+};
+
+// Grava uma partida sem bloquear quem joga: cada jogador escreve em filas SPSC
+// próprias (um jogador nunca é processado por duas threads ao mesmo tempo) e
+// uma thread de escrita codifica e grava em blocos grandes.
+// Com wait_when_full, quem não roda em tempo real (headless) espera a fila
+// esvaziar em vez de perder registros.
+class ReplayRecorder {
+public:
+    ReplayRecorder(const char* path, const std::vector<std::uint32_t>& seeds, const SpeedCurve& curve, long start_tick,
+                   bool wait_when_full = false);
+    ~ReplayRecorder();
+
+    bool is_open() const;
+    long get_dropped_events() const;
+
+    void record_input(int player, Command cmd, long tick);
+    void record_gravity(int player, long tick);
+    void record_garbage(int player, const GarbagePacket& packet, long tick);
+    void record_keyframe(int player, const Player& state);
+    void record_end(int player, const Player& state, long tick);
+    void close();
+
+private:
+    static const std::size_t EVENT_RING_SIZE = 1 << 13;
+    static const std::size_t KEYFRAME_RING_SIZE = 8;
+
+    struct Track {
+        SpscRing<ReplayEvent, EVENT_RING_SIZE> events;
+        SpscRing<Player, KEYFRAME_RING_SIZE> keyframes;
+        long last_event_tick = 0; // Só o produtor usa (keyframes herdam o tick do último registro)
+    };
+
+    std::FILE* file;
+    long start_tick;
+    bool wait_when_full;
+    std::vector<std::unique_ptr<Track>> tracks;
+    std::atomic<long> dropped_events{0};
+
+    // Usados só pela thread de escrita
+    std::vector<std::uint8_t> buffer;
+    long last_written_tick = 0;
+
+    std::atomic<bool> stopping{false};
+    std::thread writer;
+
+    void push(int player, std::uint8_t type, std::int32_t value, long tick);
+    void writer_loop();
+    void drain_all();
+    void flush();
+};
+
+// Reexecuta um replay de forma determinística: cada jogador é reconstruído a partir
+// da sua seed e dos seus registros, e seek() começa do keyframe mais próximo.
+class ReplayPlayer {
+public:
+    bool load(const char* path);
+
+    int get_num_players() const;
+    long get_ticks_per_second() const; // Do relógio que gravou (para converter em tempo real)
+    long get_tick() const;
+    long get_end_tick() const;
+    long long get_event_count() const;
+    const Player& get_player(int player) const;
+
+    void seek(long tick);
+    long long run_until(long tick);
+    bool verify(int& mismatches) const;
+
+private:
+    struct Keyframe {
+        long tick;
+        std::size_t next_event; // Primeiro registro depois do keyframe
+        Player state;
+    };
+
+    struct Track {
+        std::uint32_t seed = 0;
+        std::vector<ReplayEvent> events;
+        std::vector<Keyframe> keyframes;
+        std::size_t cursor = 0;
+        Player player;
+        bool has_end = false;
+        int final_score = 0;
+    };
+
+    SpeedCurve curve;
+    long ticks_per_second = TICKS_PER_SECOND;
+    long tick = 0;
+    long end_tick = 0;
+    long long event_count = 0;
+    int gravity_mismatches = 0;
+    std::vector<Track> tracks;
+
+    void apply(Track& track, const ReplayEvent& ev);
+};
@@ -0,0 +1,127 @@
+#include "Constants.h"
+#include "Renderer.h"
+#include "Replay.h"
+#include <chrono>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// Reexecuta um replay gravado com --record.
+//
+// Uso: tetris_replay ARQUIVO [--realtime] [--speed X] [--seek MS]
+//
+// Sem --realtime, a partida é reexecutada o mais rápido possível e o resultado
+// é comparado com o gravado. Com --realtime, os jogadores 1 e 2 são desenhados
+// no terminal na velocidade original (multiplicada por --speed).
+
+/// @brief Reexecução sem terminal, na velocidade máxima
+static int run_fast(ReplayPlayer& replay, long seek_tick) {
+    if (seek_tick > replay.get_end_tick()) seek_tick = replay.get_end_tick();
+    const double tps = static_cast<double>(replay.get_ticks_per_second());
+    auto start = std::chrono::steady_clock::now();
+    if (seek_tick > 0) replay.seek(seek_tick);
+    long long applied = replay.run_until(replay.get_end_tick());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("jogadores: %d, duracao: %.1f s (%ld ticks), registros: %lld\n", replay.get_num_players(),
+                replay.get_end_tick() / tps, replay.get_end_tick(), replay.get_event_count());
+    for (int p = 0; p < replay.get_num_players(); ++p) {
+        std::printf("J%d: %d pontos%s\n", p + 1, replay.get_player(p).get_score(),
+                    replay.get_player(p).is_game_over() ? " (perdeu)" : "");
+    }
+    std::printf("reexecucao: %.3f ms, %.0f registros/s, %.0fx o tempo real\n", seconds * 1000.0,
+                seconds > 0 ? applied / seconds : 0.0,
+                seconds > 0 ? (replay.get_end_tick() - seek_tick) / tps / seconds : 0.0);
+
+    int mismatches = 0;
+    if (replay.verify(mismatches)) {
+        std::printf("verificacao: OK\n");
+        return 0;
+    }
+    std::printf("verificacao: %d divergencias\n", mismatches);
+    return 2;
+}
+
+/// @brief Reexecução desenhada no terminal, no ritmo da partida original
+static int run_realtime(ReplayPlayer& replay, long seek_tick, double speed) {
+    setlocale(LC_ALL, "");
+    initscr();
+    cbreak();
+    noecho();
+    curs_set(0);
+    nodelay(stdscr, TRUE);
+    init_piece_colors();
+
+    WINDOW* p1_win = newwin(BOARD_HEIGHT + 2, BOARD_WIDTH * 2 + 2, P1_Y_OFFSET, P1_X_OFFSET);
+    WINDOW* p2_win = newwin(BOARD_HEIGHT + 2, BOARD_WIDTH * 2 + 2, P2_Y_OFFSET, P2_X_OFFSET);
+    WINDOW* info_win = newwin(5, 50, P1_Y_OFFSET + BOARD_HEIGHT + 3, P1_X_OFFSET);
+    BoardRenderer renderers[2];
+    BoardSnapshot snapshots[2] = {};
+    WINDOW* windows[2] = {p1_win, p2_win};
+    int shown = replay.get_num_players() < 2 ? replay.get_num_players() : 2;
+
+    replay.seek(seek_tick);
+    const double tps = static_cast<double>(replay.get_ticks_per_second());
+    auto wall_start = std::chrono::steady_clock::now();
+    bool finished = false;
+    while (getch() != QUIT_GAME) {
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_start).count();
+        long t = seek_tick + static_cast<long>(elapsed * speed * tps / 1000.0);
+        if (!finished) {
+            replay.run_until(t);
+            finished = t >= replay.get_end_tick();
+
+            for (int p = 0; p < shown; ++p) {
+                fill_snapshot(snapshots[p], replay.get_player(p), snapshots[p].version + 1);
+                renderers[p].draw(windows[p], snapshots[p]);
+            }
+            werase(info_win);
+            box(info_win, 0, 0);
+            mvwprintw(info_win, 1, 2, "Replay: %.1f / %.1f s (x%.2f)", replay.get_tick() / tps,
+                      replay.get_end_tick() / tps, speed);
+            mvwprintw(info_win, 2, 2, "J1: %d", shown > 0 ? replay.get_player(0).get_score() : 0);
+            mvwprintw(info_win, 2, 20, "J2: %d", shown > 1 ? replay.get_player(1).get_score() : 0);
+            mvwprintw(info_win, 3, 2, finished ? "Fim do replay. Pressione 'q'" : "Pressione 'q' para sair");
+            wnoutrefresh(info_win);
+            doupdate();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(33));
+    }
+
+    delwin(p1_win);
+    delwin(p2_win);
+    delwin(info_win);
+    endwin();
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Uso: %s ARQUIVO [--realtime] [--speed X] [--seek MS]\n", argv[0]);
+        return 1;
+    }
+
+    bool realtime = false;
+    double speed = 1.0;
+    long seek_ms = 0;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--realtime") == 0) realtime = true;
+        else if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc) speed = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--seek") == 0 && i + 1 < argc) seek_ms = std::atol(argv[++i]);
+        else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    ReplayPlayer replay;
+    if (!replay.load(argv[1])) {
+        std::fprintf(stderr, "Replay inválido: %s\n", argv[1]);
+        return 1;
+    }
+    // --seek é em ms de partida; o replay anda em ticks do relógio que o gravou
+    long seek_tick = seek_ms * replay.get_ticks_per_second() / 1000;
+    return realtime ? run_realtime(replay, seek_tick, speed > 0 ? speed : 1.0) : run_fast(replay, seek_tick);
+}
@@ -0,0 +1,81 @@
+#include "CpuAffinity.h"
+#include "MatchServer.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Servidor de partidas local: hospeda muitas partidas simultâneas num processo.
+//
+// Uso: tetris_server [--socket CAMINHO] [--workers N] [--max-matches N]
+//                    [--seed S] [--level L] [--time-scale X] [--cpus LISTA]
+//                    [--targeting next|random|leader|all]
+//
+// Os clientes (tetris_client, ou qualquer programa que fale ServerProtocol.h)
+// se conectam ao socket Unix (/tmp/tetris_server.sock por padrão), pedem uma
+// partida de N jogadores e recebem o estado de todos os tabuleiros em deltas.
+// --workers threads simulam as partidas; o I/O de todas as conexões é feito
+// numa única thread com epoll. --cpus fixa os workers nesses núcleos.
+// SIGINT/SIGTERM encerram o servidor e imprimem os contadores.
+
+static MatchServer* running_server = nullptr;
+
+static void on_stop_signal(int) {
+    if (running_server) running_server->stop();
+}
+
+int main(int argc, char** argv) {
+    ServerOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Opção sem valor: %s\n", argv[i]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--socket") == 0) options.socket_path = value;
+        else if (std::strcmp(argv[i - 1], "--workers") == 0) options.workers = static_cast<unsigned>(std::atol(value));
+        else if (std::strcmp(argv[i - 1], "--max-matches") == 0) options.max_matches = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--seed") == 0) options.seed = static_cast<std::uint32_t>(std::atol(value));
+        else if (std::strcmp(argv[i - 1], "--level") == 0) options.speed_curve.start_level = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--time-scale") == 0) options.time_scale = std::atof(value);
+        else if (std::strcmp(argv[i - 1], "--cpus") == 0) {
+            if (!parse_cpu_list(value, options.cpus)) {
+                std::fprintf(stderr, "Lista de núcleos inválida: %s\n", value);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i - 1], "--targeting") == 0) {
+            if (!parse_targeting(value, options.targeting)) {
+                std::fprintf(stderr, "Modo de lixo desconhecido: %s\n", value);
+                return 1;
+            }
+        } else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", argv[i - 1]);
+            return 1;
+        }
+    }
+
+    MatchServer server(options);
+    if (!server.is_open()) {
+        std::fprintf(stderr, "Não foi possível abrir o socket %s\n", server_socket_path(options.socket_path).c_str());
+        return 1;
+    }
+    running_server = &server;
+    std::signal(SIGINT, on_stop_signal);
+    std::signal(SIGTERM, on_stop_signal);
+    std::signal(SIGPIPE, SIG_IGN); // Cliente que fechou o socket aparece como erro no write()
+
+    std::printf("Servidor em %s\n", server_socket_path(options.socket_path).c_str());
+    std::fflush(stdout);
+    server.run();
+    running_server = nullptr;
+
+    const ServerStats& stats = server.get_stats();
+    std::printf("conexoes: %lld, partidas: %lld iniciadas, %lld terminadas, pico de %d simultaneas\n",
+                stats.connections, stats.matches_started, stats.matches_finished, stats.peak_matches);
+    std::printf("comandos: %lld (%lld descartados), clientes lentos: %lld\n", stats.inputs, stats.inputs_dropped,
+                stats.slow_clients);
+    std::printf("enviado: %lld mensagens, %lld bytes em %lld writes (%.1f mensagens por write)\n",
+                stats.messages_sent, stats.bytes_sent, stats.writes,
+                stats.writes > 0 ? double(stats.messages_sent) / stats.writes : 0.0);
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include "ServerProtocol.h"
+#include <bit>
+#include <cstring>
+
+static_assert(BOARD_WIDTH % 2 == 0, "Duas células por byte nas linhas de MSG_STATE");
+static_assert(BOARD_HEIGHT <= 32, "Linhas alteradas marcadas numa máscara de 32 bits");
+
+MessageWriter::MessageWriter(std::vector<std::uint8_t>& out) : out(out), start(0) {}
+
+/// @brief Abre uma mensagem (o tamanho é preenchido por end())
+void MessageWriter::begin(MessageType type) {
+    start = out.size();
+    std::uint8_t header[MSG_HEADER_SIZE] = {type, 0, 0, 0};
+    out.insert(out.end(), header, header + MSG_HEADER_SIZE);
+}
+
+void MessageWriter::u8(std::uint8_t value) {
+    out.push_back(value);
+}
+
+void MessageWriter::u16(std::uint16_t value) {
+    bytes(&value, sizeof(value));
+}
+
+void MessageWriter::u32(std::uint32_t value) {
+    bytes(&value, sizeof(value));
+}
+
+void MessageWriter::bytes(const void* data, std::size_t size) {
+    const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+    out.insert(out.end(), p, p + size);
+}
+
+/// @brief Fecha a mensagem aberta por begin(), gravando o tamanho do corpo
+/// @return false se o corpo não cabe no cabeçalho (a mensagem é removida do buffer)
+bool MessageWriter::end() {
+    std::size_t body = out.size() - start - MSG_HEADER_SIZE;
+    if (body > MSG_MAX_BODY) {
+        out.resize(start);
+        return false;
+    }
+    std::uint16_t size = static_cast<std::uint16_t>(body);
+    std::memcpy(&out[start + 2], &size, sizeof(size));
+    return true;
+}
+
+MessageReader::MessageReader(const std::uint8_t* data, std::size_t size) : data(data), size(size), pos(0) {}
+
+bool MessageReader::u8(std::uint8_t& value) {
+    return bytes(&value, sizeof(value));
+}
+
+bool MessageReader::u16(std::uint16_t& value) {
+    return bytes(&value, sizeof(value));
+}
+
+bool MessageReader::u32(std::uint32_t& value) {
+    return bytes(&value, sizeof(value));
+}
+
+bool MessageReader::bytes(void* out, std::size_t count) {
+    if (size - pos < count) return false;
+    std::memcpy(out, data + pos, count);
+    pos += count;
+    return true;
+}
+
+std::size_t MessageReader::remaining() const {
+    return size - pos;
+}
+
+/// @brief Acrescenta bytes recebidos do socket
+void FrameParser::feed(const std::uint8_t* data, std::size_t size) {
+    // Descarta o que já foi consumido antes de crescer o buffer
+    if (pos > 0) {
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(pos));
+        pos = 0;
+    }
+    buffer.insert(buffer.end(), data, data + size);
+}
+
+/// @brief Retira a próxima mensagem completa do buffer
+/// @param type Tipo da mensagem
+/// @param body Início do corpo (aponta para dentro do buffer)
+/// @param size Tamanho do corpo
+/// @return false se ainda não chegou uma mensagem inteira
+bool FrameParser::next(MessageType& type, const std::uint8_t*& body, std::size_t& size) {
+    if (buffer.size() - pos < MSG_HEADER_SIZE) return false;
+    std::uint16_t length;
+    std::memcpy(&length, &buffer[pos + 2], sizeof(length));
+    if (buffer.size() - pos - MSG_HEADER_SIZE < length) return false;
+    type = static_cast<MessageType>(buffer[pos]);
+    body = buffer.data() + pos + MSG_HEADER_SIZE;
+    size = length;
+    pos += MSG_HEADER_SIZE + length;
+    return true;
+}
+
+/// @brief Marca um snapshot como nunca enviado: o próximo delta manda o tabuleiro inteiro
+void clear_sent_snapshot(BoardSnapshot& snapshot) {
+    std::memset(&snapshot, 0xFF, sizeof(snapshot));
+    snapshot.game_over = false;
+}
+
+/// @brief Escreve uma MSG_STATE com o que mudou em cada tabuleiro desde o último envio.
+/// Uma única mensagem cobre a partida inteira e é a mesma para todos os assentos
+/// @param writer Buffer de saída
+/// @param tick Tick da simulação em que os snapshots foram tirados
+/// @param current Estado atual de cada jogador
+/// @param sent Último estado enviado de cada jogador (atualizado para current)
+/// @return false se nada mudou (nenhuma mensagem é escrita)
+bool encode_state_delta(MessageWriter& writer, long tick, const std::vector<BoardSnapshot>& current,
+                        std::vector<BoardSnapshot>& sent) {
+    // Só monta a mensagem depois de saber quais registros entram
+    std::uint8_t flags[SERVER_MAX_PLAYERS];
+    std::uint32_t changed_rows[SERVER_MAX_PLAYERS];
+    int records = 0;
+    const int num_players = static_cast<int>(current.size());
+    for (int i = 0; i < num_players; ++i) {
+        const BoardSnapshot& now = current[i];
+        const BoardSnapshot& old = sent[i];
+        std::uint8_t f = 0;
+        if (now.piece_type != old.piece_type || now.piece_rotation != old.piece_rotation ||
+            now.piece_x != old.piece_x || now.piece_y != old.piece_y || now.ghost_y != old.ghost_y) {
+            f |= DELTA_PIECE;
+        }
+        if (now.score != old.score || now.level != old.level) f |= DELTA_SCORE;
+        if (std::memcmp(now.next_pieces, old.next_pieces, PREVIEW_SIZE) != 0) f |= DELTA_NEXT;
+        if (now.game_over && !old.game_over) f |= DELTA_OVER;
+        changed_rows[i] = 0;
+        for (int y = 0; y < BOARD_HEIGHT; ++y) {
+            if (std::memcmp(now.cells[y], old.cells[y], BOARD_WIDTH) != 0) changed_rows[i] |= 1u << y;
+        }
+        if (changed_rows[i] != 0) f |= DELTA_ROWS;
+        flags[i] = f;
+        if (f != 0) records++;
+    }
+    if (records == 0) return false;
+
+    writer.begin(MSG_STATE);
+    writer.u32(static_cast<std::uint32_t>(tick));
+    writer.u8(static_cast<std::uint8_t>(records));
+    for (int i = 0; i < num_players; ++i) {
+        if (flags[i] == 0) continue;
+        const BoardSnapshot& now = current[i];
+        writer.u8(static_cast<std::uint8_t>(i));
+        writer.u8(flags[i]);
+        if (flags[i] & DELTA_PIECE) {
+            std::int8_t piece[5] = {now.piece_type, now.piece_rotation, now.piece_x, now.piece_y, now.ghost_y};
+            writer.bytes(piece, sizeof(piece));
+        }
+        if (flags[i] & DELTA_SCORE) {
+            writer.u32(static_cast<std::uint32_t>(now.score));
+            writer.u8(static_cast<std::uint8_t>(now.level));
+        }
+        if (flags[i] & DELTA_NEXT) writer.bytes(now.next_pieces, PREVIEW_SIZE);
+        if (flags[i] & DELTA_ROWS) {
+            writer.u8(static_cast<std::uint8_t>(std::popcount(changed_rows[i])));
+            for (std::uint32_t rows = changed_rows[i]; rows != 0; rows &= rows - 1) {
+                int y = std::countr_zero(rows);
+                writer.u8(static_cast<std::uint8_t>(y));
+                for (int x = 0; x < BOARD_WIDTH; x += 2) {
+                    writer.u8(static_cast<std::uint8_t>(now.cells[y][x] | (now.cells[y][x + 1] << 4)));
+                }
+            }
+        }
+        sent[i] = now;
+    }
+    writer.end();
+    return true;
+}
+
+/// @brief Aplica o corpo de uma MSG_STATE sobre os tabuleiros do cliente
+/// @param reader Corpo da mensagem
+/// @param tick Tick da simulação informado pelo servidor
+/// @param boards Estado de cada jogador (o tamanho é o número de jogadores da partida)
+/// @return false se a mensagem está mal formada
+bool decode_state_delta(MessageReader& reader, long& tick, std::vector<BoardSnapshot>& boards) {
+    std::uint32_t raw_tick;
+    std::uint8_t records;
+    if (!reader.u32(raw_tick) || !reader.u8(records)) return false;
+    tick = static_cast<long>(raw_tick);
+
+    for (int r = 0; r < records; ++r) {
+        std::uint8_t index;
+        std::uint8_t flags;
+        if (!reader.u8(index) || !reader.u8(flags) || index >= boards.size()) return false;
+        BoardSnapshot& board = boards[index];
+        if (flags & DELTA_PIECE) {
+            std::int8_t piece[5];
+            if (!reader.bytes(piece, sizeof(piece))) return false;
+            board.piece_type = piece[0];
+            board.piece_rotation = piece[1];
+            board.piece_x = piece[2];
+            board.piece_y = piece[3];
+            board.ghost_y = piece[4];
+        }
+        if (flags & DELTA_SCORE) {
+            std::uint32_t score;
+            std::uint8_t level;
+            if (!reader.u32(score) || !reader.u8(level)) return false;
+            board.score = static_cast<int>(score);
+            board.level = level;
+        }
+        if ((flags & DELTA_NEXT) && !reader.bytes(board.next_pieces, PREVIEW_SIZE)) return false;
+        if (flags & DELTA_OVER) board.game_over = true;
+        if (flags & DELTA_ROWS) {
+            std::uint8_t count;
+            if (!reader.u8(count)) return false;
+            for (int i = 0; i < count; ++i) {
+                std::uint8_t y;
+                std::uint8_t packed[BOARD_WIDTH / 2];
+                if (!reader.u8(y) || y >= BOARD_HEIGHT || !reader.bytes(packed, sizeof(packed))) return false;
+                for (int x = 0; x < BOARD_WIDTH; x += 2) {
+                    board.cells[y][x] = packed[x / 2] & 0x0F;
+                    board.cells[y][x + 1] = packed[x / 2] >> 4;
+                }
+            }
+        }
+        board.version++;
+    }
+    return true;
+}
+
+/// @brief Caminho do socket do servidor (padrão em /tmp)
+std::string server_socket_path(const char* path) {
+    return path ? path : "/tmp/tetris_server.sock";
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Player.h"
+#include "Snapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Protocolo binário entre o tetris_server e seus clientes (socket Unix, mesmo host).
+// Cada mensagem é um cabeçalho de 4 bytes (tipo, 1 byte livre, tamanho do corpo
+// em 16 bits) seguido do corpo. Os inteiros vão na ordem de bytes da máquina:
+// cliente e servidor sempre rodam no mesmo host.
+//
+// Cliente -> servidor: MSG_JOIN (entra na fila de uma partida de N jogadores) e
+// MSG_INPUT (um comando do jogador). Servidor -> cliente: MSG_START, MSG_STATE
+// (deltas de todos os tabuleiros da partida desde o último envio) e MSG_END.
+const std::uint16_t SERVER_PROTOCOL_VERSION = 1;
+const int SERVER_MAX_PLAYERS = 8;
+const std::size_t MSG_HEADER_SIZE = 4;
+const std::size_t MSG_MAX_BODY = 0xFFFF;
+
+enum MessageType : std::uint8_t {
+    MSG_JOIN = 1,  // u16 versão, u8 jogadores
+    MSG_INPUT = 2, // u8 comando
+    MSG_START = 3, // u32 partida, u32 seed, u8 assento, u8 jogadores
+    MSG_STATE = 4, // u32 tick, u8 registros, registros (encode_state_delta)
+    MSG_END = 5,   // u32 partida, i8 vencedor (-1 = empate), u32 tick
+};
+
+// Campos de um registro de MSG_STATE que mudaram desde o último envio
+enum DeltaFlags : std::uint8_t {
+    DELTA_PIECE = 1 << 0, // i8 tipo, rotação, x, y, linha do fantasma
+    DELTA_SCORE = 1 << 1, // i32 pontos, u8 nível
+    DELTA_NEXT = 1 << 2,  // PREVIEW_SIZE x i8
+    DELTA_OVER = 1 << 3,  // O jogador perdeu (sem corpo)
+    DELTA_ROWS = 1 << 4,  // u8 linhas, e para cada uma: u8 y + cores em 4 bits (BOARD_WIDTH / 2 bytes)
+};
+
+// Monta mensagens no fim de um buffer de saída
+class MessageWriter {
+public:
+    explicit MessageWriter(std::vector<std::uint8_t>& out);
+
+    void begin(MessageType type);
+    void u8(std::uint8_t value);
+    void u16(std::uint16_t value);
+    void u32(std::uint32_t value);
+    void bytes(const void* data, std::size_t size);
+    bool end(); // false se o corpo passou de MSG_MAX_BODY (a mensagem é descartada)
+
+private:
+    std::vector<std::uint8_t>& out;
+    std::size_t start; // Onde começa o cabeçalho da mensagem aberta
+};
+
+// Lê os campos do corpo de uma mensagem, sem passar do fim
+class MessageReader {
+public:
+    MessageReader(const std::uint8_t* data, std::size_t size);
+
+    bool u8(std::uint8_t& value);
+    bool u16(std::uint16_t& value);
+    bool u32(std::uint32_t& value);
+    bool bytes(void* data, std::size_t size);
+    std::size_t remaining() const;
+
+private:
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t pos;
+};
+
+// Separa um fluxo de bytes do socket em mensagens completas
+class FrameParser {
+public:
+    void feed(const std::uint8_t* data, std::size_t size);
+
+    // Próxima mensagem completa; o corpo vale até a próxima chamada de feed()/next()
+    bool next(MessageType& type, const std::uint8_t*& body, std::size_t& size);
+
+private:
+    std::vector<std::uint8_t> buffer;
+    std::size_t pos = 0;
+};
+
+bool encode_state_delta(MessageWriter& writer, long tick, const std::vector<BoardSnapshot>& current,
+                        std::vector<BoardSnapshot>& sent);
+bool decode_state_delta(MessageReader& reader, long& tick, std::vector<BoardSnapshot>& boards);
+void clear_sent_snapshot(BoardSnapshot& snapshot);
+
+std::string server_socket_path(const char* path);
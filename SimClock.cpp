@@ -0,0 +1,61 @@
+#include "SimClock.h"
+#include <chrono>
+#include <cmath>
+
+// Ticks entre quedas nos níveis 1..13: (0.8 - (nível - 1) * 0.007) ^ (nível - 1) segundos
+static const long GRAVITY_TABLE[] = {60, 48, 37, 28, 21, 16, 11, 8, 6, 4, 3, 2, 1};
+static const int GRAVITY_LEVELS = sizeof(GRAVITY_TABLE) / sizeof(GRAVITY_TABLE[0]);
+
+/// @brief Nível correspondente a um total de linhas limpas
+/// @param lines Linhas limpas desde o início da partida
+int SpeedCurve::level_for_lines(int lines) const {
+    int per_level = lines_per_level > 0 ? lines_per_level : 10;
+    int level = start_level + lines / per_level;
+    return level < 1 ? 1 : level;
+}
+
+/// @brief Intervalo da gravidade num nível
+/// @param level Nível (1 = mais lento)
+/// @return Ticks entre duas quedas automáticas (no mínimo 1)
+long SpeedCurve::gravity_ticks(int level) const {
+    if (level < 1) level = 1;
+    return level <= GRAVITY_LEVELS ? GRAVITY_TABLE[level - 1] : 1;
+}
+
+SimClock::SimClock(double time_scale)
+    : time_scale(time_scale > 0.0 ? time_scale : 1.0),
+      ns_per_tick(1e9 / TICKS_PER_SECOND / this->time_scale),
+      start_ns(steady_ns()) {}
+
+long long SimClock::steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SimClock::start() {
+    start_ns = steady_ns();
+}
+
+/// @brief Tick atual
+long SimClock::now() const {
+    return tick_at(steady_ns());
+}
+
+/// @brief Tick em que cai um instante do steady_clock (antes do início: tick 0)
+long SimClock::tick_at(long long steady_ns) const {
+    if (steady_ns <= start_ns) return 0;
+    return static_cast<long>(static_cast<double>(steady_ns - start_ns) / ns_per_tick);
+}
+
+/// @brief Início de um tick (arredondado para cima, então tick_at(tick_ns(t)) >= t)
+long long SimClock::tick_ns(long tick) const {
+    return start_ns + static_cast<long long>(std::ceil(static_cast<double>(tick) * ns_per_tick));
+}
+
+long SimClock::tick_deadline_ms(long tick) const {
+    return static_cast<long>((tick_ns(tick) + 999999) / 1000000);
+}
+
+double SimClock::get_time_scale() const {
+    return time_scale;
+}
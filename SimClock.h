@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// Tempo da simulação: tudo que altera um jogador (gravidade, comandos, lixo)
+// acontece num tick inteiro, e as regras só enxergam números de tick. Com os
+// mesmos comandos nos mesmos ticks, a partida é a mesma, não importa quando a
+// thread que processa o jogador acordou.
+const long TICKS_PER_SECOND = 60;
+
+/// @brief Converte uma duração em ms para ticks (arredondando para cima)
+inline long ms_to_ticks(long ms) {
+    return (ms * TICKS_PER_SECOND + 999) / 1000;
+}
+
+/// @brief Converte ticks para ms (arredondando para baixo)
+inline long ticks_to_ms(long ticks) {
+    return ticks * 1000 / TICKS_PER_SECOND;
+}
+
+// Curva de velocidade da gravidade: o nível sobe a cada lines_per_level linhas
+// limpas e cada nível tem um intervalo fixo, em ticks, entre as quedas
+// (tabela da diretriz oficial: 1 s por linha no nível 1, 1 tick do 13 em diante)
+struct SpeedCurve {
+    int start_level = 1;
+    int lines_per_level = 10;
+
+    int level_for_lines(int lines) const;
+    long gravity_ticks(int level) const;
+};
+
+// Relógio real da simulação para o jogo no terminal: converte o steady_clock
+// em ticks. time_scale > 1 comprime o tempo (partidas entre bots mais rápidas
+// que o tempo real); os drivers headless nem usam relógio e avançam os ticks
+// o mais rápido que a CPU permitir.
+class SimClock {
+public:
+    explicit SimClock(double time_scale = 1.0);
+
+    void start(); // O tick 0 começa agora
+    long now() const;
+    long tick_at(long long steady_ns) const;
+    long long tick_ns(long tick) const;     // Instante (ns do steady_clock) em que o tick começa
+    long tick_deadline_ms(long tick) const; // O mesmo em ms, arredondado para cima (PlayerScheduler)
+    double get_time_scale() const;
+
+    static long long steady_ns();
+
+private:
+    double time_scale;
+    double ns_per_tick; // Já dividido pelo time_scale
+    long long start_ns;
+};
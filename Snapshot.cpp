@@ -0,0 +1,26 @@
+#include "Snapshot.h"
+
+/// @brief Copia o estado atual de um jogador para um snapshot
+/// @param snapshot Destino
+/// @param player Jogador de origem
+/// @param version Número da publicação
+void fill_snapshot(BoardSnapshot& snapshot, const Player& player, std::uint32_t version) {
+    const Board& board = player.get_board();
+    for (int y = 0; y < BOARD_HEIGHT; ++y) {
+        for (int x = 0; x < BOARD_WIDTH; ++x) {
+            snapshot.cells[y][x] = static_cast<std::uint8_t>(board.get_cell(x, y));
+        }
+    }
+    snapshot.piece_type = static_cast<std::int8_t>(board.get_piece_type());
+    snapshot.piece_rotation = static_cast<std::int8_t>(board.get_piece_rotation());
+    snapshot.piece_x = static_cast<std::int8_t>(board.get_piece_x());
+    snapshot.piece_y = static_cast<std::int8_t>(board.get_piece_y());
+    snapshot.ghost_y = static_cast<std::int8_t>(board.get_piece_y() + board.get_drop_distance());
+    for (int i = 0; i < PREVIEW_SIZE; ++i) {
+        snapshot.next_pieces[i] = static_cast<std::int8_t>(board.get_next_piece(i));
+    }
+    snapshot.game_over = player.is_game_over();
+    snapshot.score = player.get_score();
+    snapshot.level = player.get_level();
+    snapshot.version = version;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Player.h"
+#include <cstdint>
+
+// Cópia compacta e imutável do estado de um jogador, publicada pela thread do
+// jogador e lida pela renderização sem travar o tabuleiro
+struct BoardSnapshot {
+    std::uint8_t cells[BOARD_HEIGHT][BOARD_WIDTH]; // Cor de cada célula fixa (0 = vazia)
+    std::int8_t piece_type;
+    std::int8_t piece_rotation;
+    std::int8_t piece_x;
+    std::int8_t piece_y;
+    std::int8_t ghost_y; // Onde a peça pararia com um hard drop
+    std::int8_t next_pieces[PREVIEW_SIZE]; // Fila de preview (0 = a próxima)
+    bool game_over;
+    int score;
+    int level; // Nível da curva de velocidade
+    std::uint32_t version; // Cresce a cada publicação do mesmo jogador
+};
+
+void fill_snapshot(BoardSnapshot& snapshot, const Player& player, std::uint32_t version);
@@ -0,0 +1,174 @@
+#include "SpectatorRing.h"
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// @brief Nome do segmento para shm_open (precisa começar com '/')
+std::string spectator_shm_name(const char* name) {
+    std::string shm_name = name ? name : "tetris";
+    if (shm_name.empty() || shm_name[0] != '/') return "/" + shm_name;
+    return shm_name;
+}
+
+/// @brief Cria (ou recria) o segmento compartilhado
+/// @param name Nome do segmento; os espectadores abrem o mesmo nome
+SpectatorWriter::SpectatorWriter(const char* name) : name(spectator_shm_name(name)), shared(nullptr), next(0) {
+    int fd = shm_open(this->name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return;
+    if (ftruncate(fd, sizeof(SpectatorShared)) != 0) {
+        ::close(fd);
+        return;
+    }
+    void* memory = mmap(nullptr, sizeof(SpectatorShared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) return;
+
+    // Um segmento que sobrou de uma partida anterior é reiniciado do zero
+    std::memset(memory, 0, sizeof(SpectatorShared));
+    shared = new (memory) SpectatorShared;
+    shared->version = SPECTATOR_VERSION;
+    shared->capacity = SPECTATOR_CAPACITY;
+    shared->frame_size = sizeof(SpectatorFrame);
+    shared->head.store(0, std::memory_order_relaxed);
+    shared->closed.store(0, std::memory_order_relaxed);
+    for (SpectatorShared::Slot& slot : shared->slots) slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::atomic_ref<std::uint32_t>(shared->magic).store(SPECTATOR_MAGIC, std::memory_order_relaxed);
+}
+
+SpectatorWriter::~SpectatorWriter() {
+    close();
+}
+
+bool SpectatorWriter::is_open() const {
+    return shared != nullptr;
+}
+
+/// @brief Começa o próximo quadro, escrito direto no slot do anel
+/// @return Quadro a preencher (boards, contagens); commit_frame() o publica
+SpectatorFrame& SpectatorWriter::begin_frame() {
+    SpectatorShared::Slot& slot = shared->slots[next % SPECTATOR_CAPACITY];
+    slot.sequence.store(2 * next + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return slot.frame;
+}
+
+/// @brief Publica o quadro começado por begin_frame()
+void SpectatorWriter::commit_frame() {
+    SpectatorShared::Slot& slot = shared->slots[next % SPECTATOR_CAPACITY];
+    slot.frame.number = next;
+    slot.sequence.store(2 * next + 2, std::memory_order_release);
+    ++next;
+    shared->head.store(next, std::memory_order_release);
+}
+
+/// @brief Avisa os espectadores que a partida acabou e remove o nome do segmento
+/// (quem já o mapeou continua lendo os últimos quadros)
+void SpectatorWriter::close() {
+    if (!shared) return;
+    shared->closed.store(1, std::memory_order_release);
+    munmap(shared, sizeof(SpectatorShared));
+    shm_unlink(name.c_str());
+    shared = nullptr;
+}
+
+/// @brief Mapeia o segmento de uma partida em andamento
+/// @param name Nome passado ao jogo (--spectate)
+SpectatorReader::SpectatorReader(const char* name) : shared(nullptr), next(0), dropped(0) {
+    int fd = shm_open(spectator_shm_name(name).c_str(), O_RDONLY, 0);
+    if (fd < 0) return;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SpectatorShared))) {
+        ::close(fd);
+        return;
+    }
+    void* memory = mmap(nullptr, sizeof(SpectatorShared), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) return;
+
+    // O magic vem primeiro: só depois dele (e da barreira) os outros campos estão completos.
+    // A página é só de leitura, mas um load atômico não escreve nela
+    const SpectatorShared* candidate = static_cast<const SpectatorShared*>(memory);
+    std::uint32_t magic = std::atomic_ref<std::uint32_t>(const_cast<std::uint32_t&>(candidate->magic))
+                              .load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (magic != SPECTATOR_MAGIC || candidate->version != SPECTATOR_VERSION ||
+        candidate->capacity != SPECTATOR_CAPACITY || candidate->frame_size != sizeof(SpectatorFrame)) {
+        munmap(memory, sizeof(SpectatorShared));
+        return;
+    }
+    shared = candidate;
+}
+
+SpectatorReader::~SpectatorReader() {
+    if (shared) munmap(const_cast<SpectatorShared*>(shared), sizeof(SpectatorShared));
+}
+
+bool SpectatorReader::is_open() const {
+    return shared != nullptr;
+}
+
+/// @brief Copia um quadro do anel, se ele ainda estiver lá inteiro
+/// @param number Número do quadro
+/// @param frame Recebe a cópia
+/// @return false se o quadro ainda não foi publicado ou foi sobrescrito durante a cópia
+bool SpectatorReader::read_slot(std::uint64_t number, SpectatorFrame& frame) const {
+    const SpectatorShared::Slot& slot = shared->slots[number % SPECTATOR_CAPACITY];
+    std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before != 2 * number + 2) return false;
+    std::memcpy(&frame, &slot.frame, sizeof(SpectatorFrame));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == before;
+}
+
+/// @brief Lê o quadro mais recente, pulando os intermediários (para desenhar)
+/// @param frame Recebe o quadro
+/// @return false se não há quadro novo desde a última leitura
+bool SpectatorReader::read_latest(SpectatorFrame& frame) {
+    while (true) {
+        std::uint64_t head = shared->head.load(std::memory_order_acquire);
+        if (head <= next) return false;
+        if (read_slot(head - 1, frame)) {
+            next = head;
+            return true;
+        }
+        // O escritor deu a volta no anel durante a cópia: tenta o novo mais recente
+    }
+}
+
+/// @brief Lê o próximo quadro em ordem (para gravar). Quadros que o escritor já
+/// sobrescreveu antes de serem lidos entram em get_dropped()
+/// @param frame Recebe o quadro
+/// @return false se o leitor já alcançou o escritor
+bool SpectatorReader::read_next(SpectatorFrame& frame) {
+    while (true) {
+        std::uint64_t head = shared->head.load(std::memory_order_acquire);
+        if (head <= next) return false;
+        // O slot do quadro `head` pode estar sendo escrito agora
+        std::uint64_t oldest = (head > SPECTATOR_CAPACITY - 1) ? head - (SPECTATOR_CAPACITY - 1) : 0;
+        if (next < oldest) {
+            dropped += oldest - next;
+            next = oldest;
+        }
+        if (read_slot(next, frame)) {
+            ++next;
+            return true;
+        }
+        // Sobrescrito durante a cópia (o escritor deu a volta): conta como perdido
+        dropped++;
+        next++;
+    }
+}
+
+/// @brief A partida acabou e todos os quadros publicados já foram lidos
+bool SpectatorReader::is_finished() const {
+    return shared->closed.load(std::memory_order_acquire) != 0 &&
+           next >= shared->head.load(std::memory_order_acquire);
+}
+
+std::uint64_t SpectatorReader::get_dropped() const {
+    return dropped;
+}
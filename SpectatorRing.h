@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Snapshot.h"
+#include "SpscRing.h" // CACHE_LINE_SIZE
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Transmissão da partida para espectadores em outros processos (tetris_view).
+// A renderização do jogo escreve um quadro por atualização num anel em memória
+// compartilhada (shm_open + mmap); cada espectador mapeia o segmento só para
+// leitura e lê no próprio ritmo. O jogo nunca espera nem vê os leitores: cada
+// slot é protegido por um seqlock, e quem lê uma cópia que foi sobrescrita no
+// meio só descarta e tenta de novo. Quantos espectadores houver, o custo para
+// a partida é o mesmo.
+const std::uint32_t SPECTATOR_MAGIC = 0x57565454; // "TTVW"
+const std::uint32_t SPECTATOR_VERSION = 1;
+const int SPECTATOR_CAPACITY = 64;   // Quadros guardados no anel
+const int SPECTATOR_MAX_BOARDS = 8;  // Jogadores além deste número só entram na contagem
+
+// Um quadro: os snapshots de todos os jogadores no mesmo instante
+struct SpectatorFrame {
+    std::uint64_t number; // Sequencial a partir de 0
+    long tick;            // Tick da simulação quando o quadro foi montado
+    std::int32_t num_players;
+    std::int32_t num_boards; // min(num_players, SPECTATOR_MAX_BOARDS)
+    std::int32_t alive;
+    std::int32_t winner;     // Último vivo quando a partida acaba (-1 = em andamento ou empate)
+    BoardSnapshot boards[SPECTATOR_MAX_BOARDS];
+};
+
+static_assert(std::is_trivially_copyable<SpectatorFrame>::value, "Quadros são copiados byte a byte");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Atômicos em memória compartilhada");
+static_assert(std::atomic_ref<std::uint32_t>::is_always_lock_free, "Atômicos em memória compartilhada");
+
+// Layout do segmento compartilhado
+struct SpectatorShared {
+    std::uint32_t magic; // Escrito por último na criação (via atomic_ref): o leitor só confia no resto depois dele
+    std::uint32_t version;
+    std::uint32_t capacity;
+    std::uint32_t frame_size;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head; // Quadros já publicados
+    std::atomic<std::uint32_t> closed;                        // A partida acabou e o escritor saiu
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        // Seqlock: 2n + 1 enquanto o quadro n é escrito, 2n + 2 quando está completo
+        std::atomic<std::uint64_t> sequence;
+        SpectatorFrame frame;
+    };
+    Slot slots[SPECTATOR_CAPACITY];
+};
+
+// Lado do jogo: cria o segmento e publica quadros (um único escritor)
+class SpectatorWriter {
+public:
+    explicit SpectatorWriter(const char* name);
+    ~SpectatorWriter();
+
+    SpectatorWriter(const SpectatorWriter&) = delete;
+    SpectatorWriter& operator=(const SpectatorWriter&) = delete;
+
+    bool is_open() const;
+    SpectatorFrame& begin_frame();
+    void commit_frame();
+    void close();
+
+private:
+    std::string name;
+    SpectatorShared* shared;
+    std::uint64_t next; // Número do quadro sendo escrito
+};
+
+// Lado do espectador: mapeia o segmento só para leitura
+class SpectatorReader {
+public:
+    explicit SpectatorReader(const char* name);
+    ~SpectatorReader();
+
+    SpectatorReader(const SpectatorReader&) = delete;
+    SpectatorReader& operator=(const SpectatorReader&) = delete;
+
+    bool is_open() const;
+    bool read_latest(SpectatorFrame& frame);
+    bool read_next(SpectatorFrame& frame);
+    bool is_finished() const;
+    std::uint64_t get_dropped() const;
+
+private:
+    const SpectatorShared* shared;
+    std::uint64_t next; // Primeiro quadro ainda não lido
+    std::uint64_t dropped;
+
+    bool read_slot(std::uint64_t number, SpectatorFrame& frame) const;
+};
+
+std::string spectator_shm_name(const char* name);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Tamanho da linha de cache usado para separar os índices do produtor e do consumidor
+const std::size_t CACHE_LINE_SIZE = 64;
+
+// Fila circular limitada, wait-free, para exatamente um produtor e um consumidor.
+// O produtor só escreve em head e o consumidor só escreve em tail; cada lado
+// guarda uma cópia do índice do outro para só ler o atômico quando necessário.
+template <typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity deve ser potência de 2");
+
+public:
+    /// @brief (Produtor) Insere um item sem bloquear
+    /// @param item Item a ser inserido
+    /// @return false se a fila estiver cheia (o item é descartado)
+    bool try_push(const T& item) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h - cached_tail == Capacity) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (h - cached_tail == Capacity) return false;
+        }
+        buffer[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief (Consumidor) Consome todos os itens disponíveis num único lote:
+    /// uma leitura acquire de head e uma escrita release de tail por chamada
+    /// @param fn Função chamada para cada item, na ordem de inserção
+    /// @return Número de itens consumidos
+    template <typename Fn>
+    std::size_t drain(Fn&& fn) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t h = head.load(std::memory_order_acquire);
+        for (std::size_t i = t; i != h; ++i) {
+            fn(buffer[i & (Capacity - 1)]);
+        }
+        if (h != t) tail.store(h, std::memory_order_release);
+        return h - t;
+    }
+
+    /// @brief (Consumidor) Retira um único item, se houver
+    /// @param item Destino do item retirado
+    /// @return false se a fila estiver vazia
+    bool try_pop(T& item) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) return false;
+        item = buffer[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief (Consumidor) Checa se há itens pendentes
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed);
+    }
+
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head{0}; // Escrito pelo produtor
+    std::size_t cached_tail = 0;                               // Cópia local do produtor
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail{0}; // Escrito pelo consumidor
+
+    alignas(CACHE_LINE_SIZE) T buffer[Capacity];
+};
@@ -0,0 +1,133 @@
+#include "ThreadPool.h"
+
+// Índice do worker da thread atual no pool ao qual ela pertence (-1 fora de um pool)
+static thread_local const ThreadPool* current_pool = nullptr;
+static thread_local int current_worker = -1;
+
+ThreadPool::ThreadPool(unsigned num_threads) {
+    if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 1;
+
+    for (unsigned i = 0; i < num_threads; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned i = 0; i < num_threads; ++i) {
+        workers.emplace_back(&ThreadPool::worker_loop, this, static_cast<int>(i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    sleep_cv.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+unsigned ThreadPool::size() const {
+    return static_cast<unsigned>(workers.size());
+}
+
+/// @brief Enfileira uma tarefa. Vinda de um worker, vai para a fila dele;
+/// vinda de fora, é distribuída entre as filas em rodízio
+/// @param task Tarefa a ser executada
+void ThreadPool::submit(std::function<void()> task) {
+    int index = (current_pool == this) ? current_worker
+                                       : static_cast<int>(next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    pending.fetch_add(1, std::memory_order_release);
+
+    // Trava vazia só para não perder a notificação de um worker que está indo dormir
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    sleep_cv.notify_one();
+}
+
+/// @brief Pega uma tarefa: primeiro do fim da própria fila, depois do início das outras
+/// @param index Fila preferida (-1 para só roubar)
+/// @param task Destino da tarefa encontrada
+/// @return true se encontrou uma tarefa
+bool ThreadPool::pop_task(int index, std::function<void()>& task) {
+    if (index >= 0) {
+        WorkQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    const int n = static_cast<int>(queues.size());
+    const int start = index >= 0 ? index + 1 : 0;
+    for (int i = 0; i < n; ++i) {
+        int victim = (start + i) % n;
+        if (victim == index) continue;
+        WorkQueue& other = *queues[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Executa uma tarefa pendente na thread atual, se houver alguma
+/// @return true se uma tarefa foi executada
+bool ThreadPool::run_pending_task() {
+    if (pending.load(std::memory_order_acquire) == 0) return false;
+
+    std::function<void()> task;
+    int index = (current_pool == this) ? current_worker : -1;
+    if (!pop_task(index, task)) return false;
+
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+}
+
+void ThreadPool::worker_loop(int index) {
+    current_pool = this;
+    current_worker = index;
+
+    while (true) {
+        if (run_pending_task()) continue;
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleep_cv.wait(lock, [this] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+        if (stopping) return;
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool) : pool(&pool) {}
+
+TaskGroup::TaskGroup(ThreadPool* pool) : pool(pool) {}
+
+TaskGroup::~TaskGroup() {
+    wait();
+}
+
+/// @brief Executa uma tarefa no pool como parte deste grupo
+void TaskGroup::run(std::function<void()> task) {
+    if (!pool) {
+        task();
+        return;
+    }
+    outstanding.fetch_add(1, std::memory_order_relaxed);
+    pool->submit([this, task = std::move(task)] {
+        task();
+        outstanding.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+/// @brief Espera todas as tarefas do grupo, executando tarefas pendentes enquanto isso
+void TaskGroup::wait() {
+    while (outstanding.load(std::memory_order_acquire) > 0) {
+        if (!pool->run_pending_task()) std::this_thread::yield();
+    }
+}
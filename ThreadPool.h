@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads com roubo de tarefas (work-stealing).
+// Cada worker tem sua própria fila: empilha e desempilha tarefas no fim dela
+// (LIFO, bom para cache em buscas recursivas) e, quando fica sem trabalho,
+// rouba do início da fila de outro worker. Threads de fora do pool que esperam
+// um TaskGroup também ajudam a executar tarefas em vez de dormir.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned num_threads = 0); // 0 = um worker por núcleo
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    bool run_pending_task();
+    unsigned size() const;
+
+private:
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stopping{false};
+    std::atomic<long> pending{0};
+    std::atomic<unsigned> next_queue{0};
+
+    // Workers ociosos dormem aqui até uma nova tarefa chegar
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+
+    bool pop_task(int index, std::function<void()>& task);
+    void worker_loop(int index);
+};
+
+// Grupo de tarefas que podem ser esperadas juntas (e podem criar subtarefas).
+// Sem pool (nullptr), cada tarefa roda na hora, na thread de quem chama run().
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool);
+    explicit TaskGroup(ThreadPool* pool);
+    ~TaskGroup();
+
+    void run(std::function<void()> task);
+    void wait();
+
+private:
+    ThreadPool* pool;
+    std::atomic<long> outstanding{0};
+};
@@ -0,0 +1,326 @@
+#include "CpuAffinity.h"
+#include "Match.h"
+#include "SpscRing.h" // CACHE_LINE_SIZE
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Torneios headless entre configurações de bot, usando todos os núcleos.
+//
+// Uso: tetris_tournament [--bot SPEC]... [--format round-robin|bracket]
+//                         [--games N] [--threads N] [--seed S] [--level L]
+//                         [--action-ticks T] [--max-ticks T]
+//
+// SPEC é "profundidade" ou "profundidade:altura,linhas,buracos,irregularidade"
+// (os pesos de BotWeights), por exemplo --bot 1 --bot 1:-0.6,0.8,-0.4,-0.2.
+// Cada confronto é uma série de --games partidas de 2 jogadores: a partida 2k
+// e a 2k+1 usam a mesma seed (as mesmas peças) com os lados trocados. Em
+// round-robin, todos enfrentam todos; em bracket, os vencedores de cada série
+// avançam (empate em vitórias: mais lixo enviado; depois, a ordem do --bot).
+//
+// As partidas são independentes: cada thread (fixada num núcleo) pega a
+// próxima partida de um contador atômico, joga com bots seriais e acumula os
+// resultados num buffer próprio, somado aos das outras só no fim.
+
+struct BotEntry {
+    std::string spec;
+    Bot bot;
+};
+
+// Um confronto: a e b são índices em BotEntry
+struct Pairing {
+    int a, b;
+};
+
+// Resultados de uma série, do ponto de vista de a
+struct SeriesStats {
+    long wins_a = 0;
+    long wins_b = 0;
+    long draws = 0;
+    long long lines_a = 0; // Lixo enviado
+    long long lines_b = 0;
+    long long score_a = 0;
+    long long score_b = 0;
+    long long ticks = 0;
+
+    void add(const SeriesStats& other) {
+        wins_a += other.wins_a;
+        wins_b += other.wins_b;
+        draws += other.draws;
+        lines_a += other.lines_a;
+        lines_b += other.lines_b;
+        score_a += other.score_a;
+        score_b += other.score_b;
+        ticks += other.ticks;
+    }
+
+    long games() const {
+        return wins_a + wins_b + draws;
+    }
+};
+
+struct TournamentOptions {
+    int games = 100;
+    unsigned threads = 0; // 0 = um por núcleo disponível
+    std::uint32_t seed = 1;
+    long action_ticks = 3;
+    long max_ticks = 18000; // 5 min de jogo: bots bons quase nunca perdem sozinhos
+    SpeedCurve curve;
+};
+
+// Buffer de resultados de um worker, numa linha de cache própria
+struct alignas(CACHE_LINE_SIZE) WorkerResults {
+    std::vector<SeriesStats> series;
+};
+
+/// @brief Joga uma partida entre dois bots
+/// @param match Partida reaproveitada pelo worker
+/// @param seat0 Bot que joga como jogador 1
+/// @param seat1 Bot que joga como jogador 2
+/// @return Ticks jogados
+static long play_match(Match& match, const Bot& seat0, const Bot& seat1, std::uint32_t seed,
+                       const TournamentOptions& options) {
+    long tick = 0;
+    match.reset(tick, seed);
+    while (!match.is_over() && tick < options.max_ticks) {
+        if (tick % options.action_ticks == 0) {
+            match.play_bot(0, seat0, tick);
+            match.play_bot(1, seat1, tick);
+        }
+        tick++;
+        match.update(tick);
+    }
+    return tick;
+}
+
+/// @brief Joga todas as partidas de um conjunto de séries em paralelo
+/// @return Resultados de cada série, na ordem de `pairings`
+static std::vector<SeriesStats> run_series(const std::vector<BotEntry>& bots, const std::vector<Pairing>& pairings,
+                                           const TournamentOptions& options, const std::vector<int>& cpus,
+                                           long long& total_ticks) {
+    const long long total_jobs = static_cast<long long>(pairings.size()) * options.games;
+    unsigned num_workers = options.threads > 0 ? options.threads : static_cast<unsigned>(cpus.size());
+    if (num_workers > total_jobs) num_workers = static_cast<unsigned>(total_jobs > 0 ? total_jobs : 1);
+
+    std::vector<WorkerResults> results(num_workers);
+    alignas(CACHE_LINE_SIZE) std::atomic<long long> next_job{0};
+
+    auto worker = [&](unsigned index) {
+        WorkerResults& mine = results[index];
+        mine.series.assign(pairings.size(), SeriesStats());
+        Match match(2, TARGET_NEXT, true, options.curve);
+        while (true) {
+            long long job = next_job.fetch_add(1, std::memory_order_relaxed);
+            if (job >= total_jobs) break;
+            int series = static_cast<int>(job / options.games);
+            int game = static_cast<int>(job % options.games);
+            const Pairing& pairing = pairings[series];
+
+            // Partidas 2k e 2k+1: mesmas peças, lados trocados
+            bool swapped = (game & 1) != 0;
+            std::uint32_t seed = options.seed + static_cast<std::uint32_t>(game / 2);
+            const Bot& seat0 = bots[swapped ? pairing.b : pairing.a].bot;
+            const Bot& seat1 = bots[swapped ? pairing.a : pairing.b].bot;
+            long ticks = play_match(match, seat0, seat1, seed, options);
+
+            SeriesStats& stats = mine.series[series];
+            int seat_a = swapped ? 1 : 0;
+            int winner = match.get_winner();
+            if (winner < 0) stats.draws++;
+            else if (winner == seat_a) stats.wins_a++;
+            else stats.wins_b++;
+            stats.lines_a += match.get_lines_sent(seat_a);
+            stats.lines_b += match.get_lines_sent(1 - seat_a);
+            stats.score_a += match.get_player(seat_a).get_score();
+            stats.score_b += match.get_player(1 - seat_a).get_score();
+            stats.ticks += ticks;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < num_workers; ++i) {
+        threads.emplace_back(worker, i);
+        pin_thread(threads.back().native_handle(), cpus[i % cpus.size()]);
+    }
+    for (std::thread& t : threads) t.join();
+
+    // Soma os buffers dos workers só depois que todos terminaram
+    std::vector<SeriesStats> merged(pairings.size());
+    for (const WorkerResults& r : results) {
+        for (std::size_t s = 0; s < r.series.size(); ++s) merged[s].add(r.series[s]);
+    }
+    for (const SeriesStats& s : merged) total_ticks += s.ticks;
+    return merged;
+}
+
+/// @brief Lê "profundidade[:altura,linhas,buracos,irregularidade]"
+static bool parse_bot(const char* spec, BotEntry& entry) {
+    char* end = nullptr;
+    long depth = std::strtol(spec, &end, 10);
+    if (end == spec || depth < 1) return false;
+    BotWeights weights;
+    if (*end == ':') {
+        double* fields[] = {&weights.height, &weights.lines, &weights.holes, &weights.bumpiness};
+        const char* p = end + 1;
+        for (int i = 0; i < 4; ++i) {
+            *fields[i] = std::strtod(p, &end);
+            if (end == p) return false;
+            p = end;
+            if (i < 3) {
+                if (*p != ',') return false;
+                ++p;
+            }
+        }
+    }
+    if (*end != '\0') return false;
+    entry.spec = spec;
+    entry.bot = Bot(static_cast<int>(depth), weights);
+    return true;
+}
+
+/// @brief Pontuação de um bot numa série: vitórias + metade dos empates
+static double win_rate(long wins, long draws, long games) {
+    return games > 0 ? (wins + 0.5 * draws) / games : 0.0;
+}
+
+static void print_round_robin(const std::vector<BotEntry>& bots, const std::vector<Pairing>& pairings,
+                              const std::vector<SeriesStats>& results) {
+    const int n = static_cast<int>(bots.size());
+    std::vector<SeriesStats> totals(n); // Do ponto de vista de cada bot (a = ele)
+    std::vector<std::vector<double>> matrix(n, std::vector<double>(n, -1.0));
+    for (std::size_t s = 0; s < pairings.size(); ++s) {
+        const SeriesStats& r = results[s];
+        int a = pairings[s].a, b = pairings[s].b;
+        SeriesStats as_b;
+        as_b.wins_a = r.wins_b;
+        as_b.wins_b = r.wins_a;
+        as_b.draws = r.draws;
+        as_b.lines_a = r.lines_b;
+        as_b.score_a = r.score_b;
+        totals[a].add(r);
+        totals[b].add(as_b);
+        matrix[a][b] = win_rate(r.wins_a, r.draws, r.games());
+        matrix[b][a] = win_rate(r.wins_b, r.draws, r.games());
+    }
+
+    std::printf("%-4s %-36s %8s %8s %8s %8s %7s %8s %10s\n", "bot", "config", "partidas", "vitorias", "empates",
+                "derrotas", "taxa", "lixo/p", "pontos/p");
+    for (int i = 0; i < n; ++i) {
+        const SeriesStats& t = totals[i];
+        long games = t.games();
+        std::printf("B%-3d %-36s %8ld %8ld %8ld %8ld %6.1f%% %8.2f %10.1f\n", i + 1, bots[i].spec.c_str(), games,
+                    t.wins_a, t.draws, t.wins_b, 100.0 * win_rate(t.wins_a, t.draws, games),
+                    games > 0 ? double(t.lines_a) / games : 0.0, games > 0 ? double(t.score_a) / games : 0.0);
+    }
+
+    std::printf("\ntaxa de vitoria (linha contra coluna):\n     ");
+    for (int j = 0; j < n; ++j) std::printf(" %6s%-2d", "B", j + 1);
+    std::printf("\n");
+    for (int i = 0; i < n; ++i) {
+        std::printf("B%-3d ", i + 1);
+        for (int j = 0; j < n; ++j) {
+            if (matrix[i][j] < 0) std::printf(" %8s", "-");
+            else std::printf(" %7.1f%%", 100.0 * matrix[i][j]);
+        }
+        std::printf("\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    TournamentOptions options;
+    std::vector<BotEntry> bots;
+    bool bracket = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Opção sem valor: %s\n", argv[i]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--bot") == 0) {
+            BotEntry entry{"", Bot(1)};
+            if (!parse_bot(value, entry)) {
+                std::fprintf(stderr, "Bot inválido: %s\n", value);
+                return 1;
+            }
+            bots.push_back(entry);
+        } else if (std::strcmp(argv[i - 1], "--format") == 0) {
+            if (std::strcmp(value, "bracket") == 0) bracket = true;
+            else if (std::strcmp(value, "round-robin") != 0) {
+                std::fprintf(stderr, "Formato desconhecido: %s\n", value);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i - 1], "--games") == 0) options.games = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--threads") == 0) options.threads = static_cast<unsigned>(std::atol(value));
+        else if (std::strcmp(argv[i - 1], "--seed") == 0) options.seed = static_cast<std::uint32_t>(std::atol(value));
+        else if (std::strcmp(argv[i - 1], "--level") == 0) options.curve.start_level = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--action-ticks") == 0) options.action_ticks = std::atol(value);
+        else if (std::strcmp(argv[i - 1], "--max-ticks") == 0) options.max_ticks = std::atol(value);
+        else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", argv[i - 1]);
+            return 1;
+        }
+    }
+
+    // Sem --bot: a profundidade 1 contra a 2, com os pesos padrão
+    if (bots.empty()) {
+        bots.push_back({"1", Bot(1)});
+        bots.push_back({"2", Bot(2)});
+    }
+    if (bots.size() < 2) {
+        std::fprintf(stderr, "Um torneio precisa de pelo menos 2 bots\n");
+        return 1;
+    }
+    if (options.games < 1) options.games = 1;
+    if (options.action_ticks < 1) options.action_ticks = 1;
+
+    const std::vector<int> cpus = available_cpus();
+    unsigned workers = options.threads > 0 ? options.threads : static_cast<unsigned>(cpus.size());
+    long long total_ticks = 0;
+    long long total_games = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    if (!bracket) {
+        std::vector<Pairing> pairings;
+        for (int a = 0; a < static_cast<int>(bots.size()); ++a) {
+            for (int b = a + 1; b < static_cast<int>(bots.size()); ++b) pairings.push_back({a, b});
+        }
+        std::vector<SeriesStats> results = run_series(bots, pairings, options, cpus, total_ticks);
+        total_games = static_cast<long long>(pairings.size()) * options.games;
+        print_round_robin(bots, pairings, results);
+    } else {
+        // Chave de eliminação simples: 1 contra 2, 3 contra 4...; sobrando um, ele passa direto
+        std::vector<int> alive;
+        for (int i = 0; i < static_cast<int>(bots.size()); ++i) alive.push_back(i);
+        for (int round = 1; alive.size() > 1; ++round) {
+            std::vector<Pairing> pairings;
+            for (std::size_t i = 0; i + 1 < alive.size(); i += 2) pairings.push_back({alive[i], alive[i + 1]});
+            std::vector<SeriesStats> results = run_series(bots, pairings, options, cpus, total_ticks);
+            total_games += static_cast<long long>(pairings.size()) * options.games;
+
+            std::vector<int> next;
+            for (std::size_t s = 0; s < pairings.size(); ++s) {
+                const SeriesStats& r = results[s];
+                int a = pairings[s].a, b = pairings[s].b;
+                bool a_wins = r.wins_a != r.wins_b ? r.wins_a > r.wins_b : r.lines_a >= r.lines_b;
+                next.push_back(a_wins ? a : b);
+                std::printf("rodada %d: B%d (%s) x B%d (%s): %ld-%ld, %ld empates, lixo %.2f x %.2f -> B%d\n", round,
+                            a + 1, bots[a].spec.c_str(), b + 1, bots[b].spec.c_str(), r.wins_a, r.wins_b, r.draws,
+                            double(r.lines_a) / r.games(), double(r.lines_b) / r.games(), (a_wins ? a : b) + 1);
+            }
+            if (alive.size() % 2 == 1) next.push_back(alive.back());
+            alive = next;
+        }
+        std::printf("campeao: B%d (%s)\n", alive[0] + 1, bots[alive[0]].spec.c_str());
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("\npartidas: %lld, threads: %u, tempo: %.2f s, %.1f partidas/s, %.0f ticks/s\n", total_games, workers,
+                seconds, seconds > 0 ? total_games / seconds : 0.0, seconds > 0 ? total_ticks / seconds : 0.0);
+    return 0;
+}
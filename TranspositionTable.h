@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Tabela de transposição lock-free, dividida entre todas as threads de uma busca.
+// Cada entrada guarda o valor e (chave ^ valor) em dois atômicos independentes
+// ("lockless hashing"): uma leitura que pega metade de uma escrita concorrente
+// não confere com a chave e vira só um miss, sem trava nenhuma. Entradas são
+// sempre substituídas; a chave 0 é reservada (uma entrada vazia confere com ela).
+class TranspositionTable {
+public:
+    /// @param bits log2 do número de entradas (16 bytes cada)
+    explicit TranspositionTable(int bits = 20)
+        : mask((std::size_t(1) << bits) - 1), entries(new Entry[mask + 1]) {}
+
+    /// @brief Procura uma chave (qualquer thread)
+    /// @param key Chave da posição (diferente de 0)
+    /// @param value Recebe o valor guardado, se encontrado
+    /// @return true se a chave estava na tabela
+    bool probe(std::uint64_t key, std::uint64_t& value) const {
+        const Entry& entry = entries[key & mask];
+        std::uint64_t stored = entry.value.load(std::memory_order_relaxed);
+        std::uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ stored) != key) return false;
+        value = stored;
+        return true;
+    }
+
+    /// @brief Guarda um valor (qualquer thread), substituindo o que estiver na entrada
+    void store(std::uint64_t key, std::uint64_t value) {
+        Entry& entry = entries[key & mask];
+        entry.value.store(value, std::memory_order_relaxed);
+        entry.check.store(key ^ value, std::memory_order_relaxed);
+    }
+
+    /// @brief Esvazia a tabela (só com nenhuma busca em andamento)
+    void clear() {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            entries[i].value.store(0, std::memory_order_relaxed);
+            entries[i].check.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t size() const {
+        return mask + 1;
+    }
+
+private:
+    struct Entry {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::size_t mask;
+    std::unique_ptr<Entry[]> entries;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "SpscRing.h" // CACHE_LINE_SIZE
+#include <atomic>
+#include <cstdint>
+
+// Buffer triplo para um escritor e um leitor: o escritor sempre tem um buffer
+// livre para escrever e o leitor sempre lê uma cópia completa e imutável.
+// Nenhum dos lados bloqueia ou espera o outro.
+template <typename T>
+class TripleBuffer {
+public:
+    /// @brief (Escritor) Buffer onde o próximo estado deve ser escrito
+    T& write_buffer() {
+        return buffers[back].value;
+    }
+
+    /// @brief (Escritor) Publica o buffer escrito, trocando-o pelo buffer do meio
+    void publish() {
+        back = middle.exchange(back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /// @brief (Leitor) Checa se há um estado publicado ainda não lido
+    bool has_update() const {
+        return (middle.load(std::memory_order_relaxed) & FRESH_BIT) != 0;
+    }
+
+    /// @brief (Leitor) Obtém o estado publicado mais recente
+    /// @return Referência válida até a próxima chamada de read()
+    const T& read() {
+        if (has_update()) {
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return buffers[front].value;
+    }
+
+private:
+    static const std::uint8_t INDEX_MASK = 0x3;
+    static const std::uint8_t FRESH_BIT = 0x4;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        T value{};
+    };
+
+    Slot buffers[3];
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint8_t> middle{1};
+    std::uint8_t back = 0;  // Só o escritor usa
+    std::uint8_t front = 2; // Só o leitor usa
+};
@@ -0,0 +1,131 @@
+#include "Constants.h"
+#include "Renderer.h"
+#include "SpectatorRing.h"
+#include <chrono>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+// Espectador de uma partida transmitida com `tetris --spectate NOME`.
+//
+// Uso: tetris_view [NOME] [--fps N] [--board N] [--log]
+//
+// Mapeia o segmento só para leitura e desenha dois tabuleiros (o jogador
+// --board, 1 por padrão, e o seguinte) a até --fps quadros por segundo,
+// pulando os intermediários.
+// Se a partida ainda não começou, espera por ela. Com --log, não usa o
+// terminal: lê todos os quadros em ordem, como um gravador, e imprime um
+// resumo quando a partida acaba.
+
+/// @brief Espera o segmento da partida aparecer
+/// @return Leitor aberto, ou nullptr se o usuário desistiu (só com o terminal)
+static std::unique_ptr<SpectatorReader> wait_for_match(const char* name, bool interactive) {
+    while (true) {
+        auto reader = std::make_unique<SpectatorReader>(name);
+        if (reader->is_open()) return reader;
+        if (interactive && getch() == QUIT_GAME) return nullptr;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+/// @brief Lê todos os quadros em ordem, sem terminal
+static int run_log(const char* name) {
+    std::unique_ptr<SpectatorReader> reader = wait_for_match(name, false);
+    SpectatorFrame frame;
+    long long frames = 0;
+    long last_tick = 0;
+    int winner = -1;
+    while (!reader->is_finished()) {
+        if (!reader->read_next(frame)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        frames++;
+        last_tick = frame.tick;
+        winner = frame.winner;
+    }
+    std::printf("quadros: %lld, perdidos: %llu\n", frames, static_cast<unsigned long long>(reader->get_dropped()));
+    std::printf("duracao: %.1f s (%ld ticks), vencedor: ", static_cast<double>(last_tick) / TICKS_PER_SECOND, last_tick);
+    if (winner >= 0) std::printf("J%d\n", winner + 1);
+    else std::printf("nenhum\n");
+    return 0;
+}
+
+/// @brief Desenha a partida no terminal, no ritmo do espectador
+static int run_view(const char* name, int fps, int first_board) {
+    setlocale(LC_ALL, "");
+    initscr();
+    cbreak();
+    noecho();
+    curs_set(0);
+    nodelay(stdscr, TRUE);
+    init_piece_colors();
+
+    WINDOW* p1_win = newwin(BOARD_HEIGHT + 2, BOARD_WIDTH * 2 + 2, P1_Y_OFFSET, P1_X_OFFSET);
+    WINDOW* p2_win = newwin(BOARD_HEIGHT + 2, BOARD_WIDTH * 2 + 2, P2_Y_OFFSET, P2_X_OFFSET);
+    WINDOW* info_win = newwin(5, 50, P1_Y_OFFSET + BOARD_HEIGHT + 3, P1_X_OFFSET);
+    WINDOW* windows[2] = {p1_win, p2_win};
+    BoardRenderer renderers[2];
+
+    mvwprintw(info_win, 1, 2, "Aguardando a partida %s...", spectator_shm_name(name).c_str());
+    wrefresh(info_win);
+    std::unique_ptr<SpectatorReader> reader = wait_for_match(name, true);
+
+    SpectatorFrame frame;
+    bool finished = false;
+    while (reader && getch() != QUIT_GAME) {
+        if (!finished && reader->read_latest(frame)) {
+            werase(info_win);
+            box(info_win, 0, 0);
+            for (int w = 0; w < 2; ++w) {
+                int board = first_board + w;
+                if (board >= frame.num_boards) continue;
+                renderers[w].draw(windows[w], frame.boards[board]);
+                mvwprintw(info_win, 1 + w, 2, "Jogador %d: %d Nv%d", board + 1, frame.boards[board].score,
+                          frame.boards[board].level);
+                print_preview(info_win, 1 + w, 25, frame.boards[board]);
+            }
+            mvwprintw(info_win, 3, 2, "%.1f s", static_cast<double>(frame.tick) / TICKS_PER_SECOND);
+            if (frame.num_players > 2) mvwprintw(info_win, 3, 30, "Vivos: %d/%d", frame.alive, frame.num_players);
+            wnoutrefresh(info_win);
+            doupdate();
+        }
+        if (!finished && reader->is_finished()) {
+            finished = true;
+            if (frame.winner >= 0) mvwprintw(info_win, 3, 12, "FIM: Jogador %d venceu ('q')", frame.winner + 1);
+            else mvwprintw(info_win, 3, 12, "FIM DE JOGO ('q')");
+            wrefresh(info_win);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000 / fps));
+    }
+
+    delwin(p1_win);
+    delwin(p2_win);
+    delwin(info_win);
+    endwin();
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* name = "tetris";
+    int fps = 30;
+    int first_board = 0;
+    bool log = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--log") == 0) log = true;
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) fps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--board") == 0 && i + 1 < argc) first_board = std::atoi(argv[++i]) - 1;
+        else if (argv[i][0] != '-') name = argv[i];
+        else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (fps < 1) fps = 1;
+    if (fps > 1000) fps = 1000;
+    if (first_board < 0) first_board = 0;
+    return log ? run_log(name) : run_view(name, fps, first_board);
+}
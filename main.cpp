@@ -1,9 +1,66 @@
+#include "CpuAffinity.h"
 #include "Game.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
-int main() {
-    Game tetris_game;
+// Uso: tetris [--bot1] [--bot2] [--bot-depth D] [--bot-delay MS]
+//              [--players N] [--workers N] [--targeting next|random|leader|all]
+//              [--seed S] [--shared-seed] [--record ARQUIVO] [--metrics ARQUIVO]
+//              [--level L] [--time-scale X] [--spectate NOME]
+//              [--threading roles|reactor] [--cpus LISTA] [--rt-priority P] [--nice N]
+//              [--max-fps N]
+//
+// --level é o nível inicial da curva de velocidade da gravidade. --time-scale
+// acelera o relógio da simulação (2 = o dobro de ticks por segundo real), útil
+// para assistir partidas entre bots. Com --spectate, cada quadro também vai para
+// um segmento de memória compartilhada, que qualquer número de tetris_view
+// (em outros terminais) pode assistir sem afetar a partida.
+//
+// --threading escolhe o modelo de execução: roles (padrão) usa uma thread de
+// input, uma de renderização e o pool dos jogadores; reactor faz tudo numa
+// única thread, sem travas. --cpus (formato do taskset, "0,2-3") fixa as
+// threads nesses núcleos: no modelo roles, input no primeiro, renderização no
+// segundo e workers nos seguintes. --rt-priority usa SCHED_FIFO e --nice
+// ajusta o nice de todas as threads. Ao sair, o jogo imprime quantas trocas de
+// contexto o processo sofreu, para comparar os modelos.
+//
+// A tela só é redesenhada quando algum tabuleiro muda, no máximo --max-fps
+// vezes por segundo (30 por padrão; 0 = sem limite). Parado, o jogo não gasta CPU.
+//
+// Com --metrics, os histogramas de latência (Metrics.h) são gravados em JSON
+// no arquivo ao sair e sempre que o processo recebe SIGUSR1.
+int main(int argc, char** argv) {
+    GameOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bot1") == 0) options.bot[0] = true;
+        else if (std::strcmp(argv[i], "--bot2") == 0) options.bot[1] = true;
+        else if (std::strcmp(argv[i], "--bot-depth") == 0 && i + 1 < argc) options.bot_depth = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--bot-delay") == 0 && i + 1 < argc) options.bot_delay_ms = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--players") == 0 && i + 1 < argc) options.num_players = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) options.workers = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) options.seed = static_cast<std::uint32_t>(std::atol(argv[++i]));
+        else if (std::strcmp(argv[i], "--shared-seed") == 0) options.shared_seed = true;
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) options.record_path = argv[++i];
+        else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc) options.speed_curve.start_level = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--time-scale") == 0 && i + 1 < argc) options.time_scale = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--spectate") == 0 && i + 1 < argc) options.spectate_name = argv[++i];
+        else if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) options.metrics_path = argv[++i];
+        else if (std::strcmp(argv[i], "--threading") == 0 && i + 1 < argc && parse_threading(argv[i + 1], options.threading)) ++i;
+        else if (std::strcmp(argv[i], "--cpus") == 0 && i + 1 < argc && parse_cpu_list(argv[i + 1], options.cpus)) ++i;
+        else if (std::strcmp(argv[i], "--rt-priority") == 0 && i + 1 < argc) options.rt_priority = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--nice") == 0 && i + 1 < argc) options.nice_value = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--max-fps") == 0 && i + 1 < argc) options.max_fps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--targeting") == 0 && i + 1 < argc && parse_targeting(argv[i + 1], options.targeting)) ++i;
+        else {
+            std::fprintf(stderr, "Opção desconhecida: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    Game tetris_game(options);
     tetris_game.run();
     // O jogo rodará até 'q' ser pressionado ou alguém perder.
     
     return 0;
-}
\ No newline at end of file
+}